@@ -0,0 +1,134 @@
+// Measures frustum culling throughput (objects tested per millisecond) for 10k to 1M objects,
+// comparing the scalar and SIMD paths and scaling over thread counts.
+//
+// Usage: culling_bench [--max-threads N] [--repetitions N]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../src/culling.h"
+#include "../src/thread_pool.h"
+
+static void build_scene(CullingBounds* bounds, size_t count) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> size(0.5f, 4.0f);
+
+    bounds->clear();
+    for (size_t i = 0; i < count; i++) {
+        vec3 center = {position(rng), position(rng) * 0.1f, position(rng)};
+        vec3 extents = {size(rng), size(rng), size(rng)};
+        bounds->add(center, extents);
+    }
+}
+
+static void build_frustum(Frustum* frustum) {
+    mat4x4 projection, view, view_projection;
+    mat4x4_perspective(projection, 60.0f * 3.14159265f / 180.0f, 16.0f / 9.0f, 0.1f, 400.0f);
+
+    vec3 eye = {0.0f, 10.0f, -50.0f};
+    vec3 center = {0.0f, 0.0f, 100.0f};
+    vec3 up = {0.0f, 1.0f, 0.0f};
+    mat4x4_look_at(view, eye, center, up);
+
+    mat4x4_mul(view_projection, projection, view);
+    frustum_from_view_projection(frustum, view_projection);
+}
+
+/// Median wall time of one cull, in milliseconds.
+static double measure(FrustumCuller* culler,
+                      const CullingBounds& bounds,
+                      const Frustum& frustum,
+                      ThreadPool* pool,
+                      int repetitions,
+                      std::vector<uint32_t>* visible) {
+    for (int i = 0; i < 3; i++) {
+        culler->cull(bounds, frustum, pool, visible);
+    }
+
+    std::vector<double> samples;
+    for (int i = 0; i < repetitions; i++) {
+        auto start = std::chrono::steady_clock::now();
+        culler->cull(bounds, frustum, pool, visible);
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    int repetitions = 21;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+            max_threads = (uint32_t)std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+            repetitions = std::max(1, atoi(argv[++i]));
+        } else {
+            fprintf(stderr, "usage: %s [--max-threads N] [--repetitions N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Frustum frustum;
+    build_frustum(&frustum);
+
+    CullingBounds bounds;
+    FrustumCuller culler;
+    std::vector<uint32_t> visible;
+
+    printf("%10s %8s %6s %10s %14s %9s\n", "objects", "threads", "simd", "median_ms", "objects_per_ms", "visible");
+
+    for (size_t count : {10000, 100000, 1000000}) {
+        build_scene(&bounds, count);
+
+        // Single-threaded scalar reference.
+        culler.simd = false;
+        double scalar_ms = measure(&culler, bounds, frustum, nullptr, repetitions, &visible);
+        printf("%10zu %8u %6s %10.3f %14.0f %8.1f%%\n",
+               count,
+               1u,
+               "no",
+               scalar_ms,
+               (double)count / scalar_ms,
+               100.0 * (double)visible.size() / (double)count);
+
+        size_t scalar_visible = visible.size();
+
+        // Powers of two, plus the maximum itself.
+        std::vector<uint32_t> thread_counts;
+        for (uint32_t threads = 1; threads < max_threads; threads *= 2) {
+            thread_counts.push_back(threads);
+        }
+        thread_counts.push_back(max_threads);
+
+        culler.simd = true;
+        for (uint32_t threads : thread_counts) {
+            ThreadPool pool(threads);
+            double ms = measure(&culler, bounds, frustum, &pool, repetitions, &visible);
+            printf("%10zu %8u %6s %10.3f %14.0f %8.1f%%\n",
+                   count,
+                   threads,
+                   "yes",
+                   ms,
+                   (double)count / ms,
+                   100.0 * (double)visible.size() / (double)count);
+
+            if (visible.size() != scalar_visible) {
+                fprintf(stderr, "SIMD result differs from scalar: %zu vs %zu\n", visible.size(), scalar_visible);
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
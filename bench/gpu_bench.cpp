@@ -0,0 +1,689 @@
+// GPU microbenchmarks: draw-call throughput, upload bandwidth, shader and pipeline creation latency, command
+// encoder cost and buffer readback latency. Runs headless on the fallback (software) adapter by default so results
+// are comparable between machines, and writes one JSON object per scenario.
+//
+// Usage: gpu_bench [--scenario SUBSTRING] [--warmup N] [--repetitions N] [--output FILE] [--hardware] [--list]
+//        gpu_bench --compare BASELINE CURRENT [--threshold PERCENT] [--min-delta US]
+//
+// Compare mode reports every scenario whose median got slower than the baseline by more than the threshold
+// (default 10%) and by more than the minimum delta (default 5us), and exits with 1 if there is any.
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../src/common.h"
+
+#define LOG_PREFIX "[WGPU]"
+
+static const char* draw_shader_code = R"(
+@vertex
+fn vs_main(@builtin(vertex_index) index: u32) -> @builtin(position) vec4f {
+    let x = f32(i32(index) - 1) * 0.01;
+    let y = f32(i32(index & 1u) * 2 - 1) * 0.01;
+    return vec4f(x, y, 0.0, 1.0);
+}
+
+@fragment
+fn fs_main() -> @location(0) vec4f {
+    return vec4f(1.0, 0.5, 0.0, 1.0);
+}
+)";
+
+static const WGPUTextureFormat target_format = WGPUTextureFormat_RGBA8Unorm;
+static const uint32_t target_size = 256;
+
+struct Bench {
+    WGPUInstance instance;
+    WGPUAdapter adapter;
+    WGPUDevice device;
+    WGPUQueue queue;
+    WGPUTexture target;
+    WGPUTextureView target_view;
+    WGPUShaderModule shader_module;
+    WGPUPipelineLayout pipeline_layout;
+    WGPURenderPipeline pipeline;
+    uint32_t errors;
+};
+
+/// One scenario. `run` performs a single repetition and returns its duration in microseconds, so that it can
+/// leave setup and cleanup out of the measurement.
+struct Scenario {
+    const char* name;
+    double (*run)(Bench* bench, uint64_t param);
+    uint64_t param;
+    /// Amount of work done by one repetition, for the throughput figure. Zero if meaningless.
+    double work;
+    const char* work_unit;
+};
+
+struct Result {
+    std::string name;
+    double min, p50, p90, p99, max, mean;
+    double throughput;
+    const char* throughput_unit;
+};
+
+static void handle_request_adapter(WGPURequestAdapterStatus status,
+                                   WGPUAdapter adapter,
+                                   char const* message,
+                                   void* userdata) {
+    if (status == WGPURequestAdapterStatus_Success) {
+        auto bench = (Bench*)userdata;
+        bench->adapter = adapter;
+    } else {
+        fprintf(stderr, LOG_PREFIX " request_adapter status=%#.8x message=%s\n", status, message);
+    }
+}
+
+static void handle_request_device(WGPURequestDeviceStatus status,
+                                  WGPUDevice device,
+                                  char const* message,
+                                  void* userdata) {
+    if (status == WGPURequestDeviceStatus_Success) {
+        auto bench = (Bench*)userdata;
+        bench->device = device;
+    } else {
+        fprintf(stderr, LOG_PREFIX " request_device status=%#.8x message=%s\n", status, message);
+    }
+}
+
+static void handle_device_error(WGPUErrorType type, char const* message, void* userdata) {
+    auto bench = (Bench*)userdata;
+    bench->errors++;
+    fprintf(stderr, LOG_PREFIX " device error type=%#.8x message=%s\n", type, message);
+}
+
+static double elapsed_us(std::chrono::steady_clock::time_point start) {
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+/// Blocks until the GPU finished all submitted work.
+static void wait_idle(Bench* bench) {
+    wgpuDevicePoll(bench->device, true, nullptr);
+}
+
+static WGPURenderPipeline create_draw_pipeline(Bench* bench, const char* label) {
+    std::array<WGPUColorTargetState, 1> color_target_states = {
+        WGPUColorTargetState{
+            .format = target_format,
+            .writeMask = WGPUColorWriteMask_All,
+        },
+    };
+
+    WGPUFragmentState fragment_state = {
+        .module = bench->shader_module,
+        .entryPoint = "fs_main",
+        .targetCount = color_target_states.size(),
+        .targets = color_target_states.data(),
+    };
+
+    WGPURenderPipelineDescriptor render_pipeline_descriptor = {
+        .label = label,
+        .layout = bench->pipeline_layout,
+        .vertex =
+            WGPUVertexState{
+                .module = bench->shader_module,
+                .entryPoint = "vs_main",
+            },
+        .primitive =
+            WGPUPrimitiveState{
+                .topology = WGPUPrimitiveTopology_TriangleList,
+            },
+        .multisample =
+            WGPUMultisampleState{
+                .count = 1,
+                .mask = 0xFFFFFFFF,
+            },
+        .fragment = &fragment_state,
+    };
+
+    return wgpuDeviceCreateRenderPipeline(bench->device, &render_pipeline_descriptor);
+}
+
+static bool bench_init(Bench* bench, bool force_fallback) {
+    bench->instance = wgpuCreateInstance(nullptr);
+    assert(bench->instance);
+
+    WGPURequestAdapterOptions request_adapter_options = {
+        .powerPreference = WGPUPowerPreference_HighPerformance,
+        .forceFallbackAdapter = force_fallback,
+    };
+    wgpuInstanceRequestAdapter(bench->instance, &request_adapter_options, handle_request_adapter, bench);
+    if (!bench->adapter) {
+        if (force_fallback) {
+            fprintf(stderr, "no fallback adapter available, run with --hardware to use the default adapter\n");
+        }
+        return false;
+    }
+
+    wgpuAdapterRequestDevice(bench->adapter, nullptr, handle_request_device, bench);
+    if (!bench->device) {
+        return false;
+    }
+
+    wgpuDeviceSetUncapturedErrorCallback(bench->device, handle_device_error, bench);
+
+    bench->queue = wgpuDeviceGetQueue(bench->device);
+    assert(bench->queue);
+
+    // Offscreen target, nothing is presented.
+    WGPUTextureDescriptor texture_descriptor = {
+        .label = "bench_target",
+        .usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_CopySrc,
+        .dimension = WGPUTextureDimension_2D,
+        .size =
+            WGPUExtent3D{
+                .width = target_size,
+                .height = target_size,
+                .depthOrArrayLayers = 1,
+            },
+        .format = target_format,
+        .mipLevelCount = 1,
+        .sampleCount = 1,
+    };
+    bench->target = wgpuDeviceCreateTexture(bench->device, &texture_descriptor);
+    assert(bench->target);
+
+    bench->target_view = wgpuTextureCreateView(bench->target, nullptr);
+    assert(bench->target_view);
+
+    bench->shader_module = create_shader(bench->device, draw_shader_code, "bench_shader");
+    assert(bench->shader_module);
+
+    WGPUPipelineLayoutDescriptor pipeline_layout_descriptor = {
+        .label = "bench_pipeline_layout",
+    };
+    bench->pipeline_layout = wgpuDeviceCreatePipelineLayout(bench->device, &pipeline_layout_descriptor);
+    assert(bench->pipeline_layout);
+
+    bench->pipeline = create_draw_pipeline(bench, "bench_pipeline");
+    assert(bench->pipeline);
+
+    return true;
+}
+
+static void bench_shutdown(Bench* bench) {
+    if (bench->pipeline) {
+        wgpuRenderPipelineRelease(bench->pipeline);
+    }
+    if (bench->pipeline_layout) {
+        wgpuPipelineLayoutRelease(bench->pipeline_layout);
+    }
+    if (bench->shader_module) {
+        wgpuShaderModuleRelease(bench->shader_module);
+    }
+    if (bench->target_view) {
+        wgpuTextureViewRelease(bench->target_view);
+    }
+    if (bench->target) {
+        wgpuTextureDestroy(bench->target);
+        wgpuTextureRelease(bench->target);
+    }
+    if (bench->queue) {
+        wgpuQueueRelease(bench->queue);
+    }
+    if (bench->device) {
+        wgpuDeviceRelease(bench->device);
+    }
+    if (bench->adapter) {
+        wgpuAdapterRelease(bench->adapter);
+    }
+    if (bench->instance) {
+        wgpuInstanceRelease(bench->instance);
+    }
+}
+
+//-----------------
+// Scenarios
+//-----------------
+
+/// `param` single-triangle draws in one pass, encoded, submitted and waited for.
+static double run_draw_calls(Bench* bench, uint64_t param) {
+    auto start = std::chrono::steady_clock::now();
+
+    WGPUCommandEncoder command_encoder = wgpuDeviceCreateCommandEncoder(bench->device, nullptr);
+
+    std::array<WGPURenderPassColorAttachment, 1> render_pass_color_attachments = {
+        WGPURenderPassColorAttachment{
+            .view = bench->target_view,
+            .loadOp = WGPULoadOp_Clear,
+            .storeOp = WGPUStoreOp_Store,
+        },
+    };
+
+    WGPURenderPassDescriptor render_pass_descriptor = {
+        .colorAttachmentCount = render_pass_color_attachments.size(),
+        .colorAttachments = render_pass_color_attachments.data(),
+    };
+
+    WGPURenderPassEncoder render_pass_encoder =
+        wgpuCommandEncoderBeginRenderPass(command_encoder, &render_pass_descriptor);
+    wgpuRenderPassEncoderSetPipeline(render_pass_encoder, bench->pipeline);
+    for (uint64_t i = 0; i < param; i++) {
+        wgpuRenderPassEncoderDraw(render_pass_encoder, 3, 1, 0, 0);
+    }
+    wgpuRenderPassEncoderEnd(render_pass_encoder);
+
+    WGPUCommandBuffer command_buffer = wgpuCommandEncoderFinish(command_encoder, nullptr);
+    wgpuQueueSubmit(bench->queue, 1, &command_buffer);
+    wait_idle(bench);
+
+    double us = elapsed_us(start);
+
+    wgpuCommandBufferRelease(command_buffer);
+    wgpuRenderPassEncoderRelease(render_pass_encoder);
+    wgpuCommandEncoderRelease(command_encoder);
+    return us;
+}
+
+/// Creating and finishing an empty command encoder.
+static double run_encoder_finish(Bench* bench, uint64_t) {
+    auto start = std::chrono::steady_clock::now();
+
+    WGPUCommandEncoder command_encoder = wgpuDeviceCreateCommandEncoder(bench->device, nullptr);
+    WGPUCommandBuffer command_buffer = wgpuCommandEncoderFinish(command_encoder, nullptr);
+
+    double us = elapsed_us(start);
+
+    wgpuCommandBufferRelease(command_buffer);
+    wgpuCommandEncoderRelease(command_encoder);
+    return us;
+}
+
+/// `param` bytes through `write_buffer` into an existing buffer, until the GPU has them.
+static double run_write_buffer(Bench* bench, uint64_t param) {
+    std::vector<uint8_t> data(param, 0xAB);
+    WGPUBuffer buffer = create_buffer(bench->device, bench->queue, param, WGPUBufferUsage_Vertex);
+    wait_idle(bench);
+
+    auto start = std::chrono::steady_clock::now();
+
+    write_buffer(bench->queue, buffer, 0, data.data(), data.size());
+    // Queue writes are flushed with the next submission.
+    wgpuQueueSubmit(bench->queue, 0, nullptr);
+    wait_idle(bench);
+
+    double us = elapsed_us(start);
+
+    wgpuBufferDestroy(buffer);
+    wgpuBufferRelease(buffer);
+    return us;
+}
+
+/// Creating a buffer of `param` bytes with its contents through `create_buffer`, until the GPU has them.
+static double run_create_buffer(Bench* bench, uint64_t param) {
+    std::vector<uint8_t> data(param, 0xAB);
+
+    auto start = std::chrono::steady_clock::now();
+
+    WGPUBuffer buffer = create_buffer(bench->device, bench->queue, param, WGPUBufferUsage_Vertex, data.data());
+    wgpuQueueSubmit(bench->queue, 0, nullptr);
+    wait_idle(bench);
+
+    double us = elapsed_us(start);
+
+    wgpuBufferDestroy(buffer);
+    wgpuBufferRelease(buffer);
+    return us;
+}
+
+static double run_shader_module_create(Bench* bench, uint64_t) {
+    auto start = std::chrono::steady_clock::now();
+
+    WGPUShaderModule shader_module = create_shader(bench->device, draw_shader_code, "bench_shader");
+
+    double us = elapsed_us(start);
+
+    wgpuShaderModuleRelease(shader_module);
+    return us;
+}
+
+static double run_pipeline_create(Bench* bench, uint64_t) {
+    auto start = std::chrono::steady_clock::now();
+
+    WGPURenderPipeline pipeline = create_draw_pipeline(bench, "bench_pipeline");
+
+    double us = elapsed_us(start);
+
+    wgpuRenderPipelineRelease(pipeline);
+    return us;
+}
+
+static void handle_buffer_map(WGPUBufferMapAsyncStatus status, void* userdata) {
+    *(WGPUBufferMapAsyncStatus*)userdata = status;
+}
+
+/// Copying `param` bytes into a staging buffer, mapping it and reading it on the CPU.
+static double run_readback(Bench* bench, uint64_t param) {
+    std::vector<uint8_t> data(param, 0xAB);
+    WGPUBuffer source = create_buffer(bench->device, bench->queue, param, WGPUBufferUsage_CopySrc, data.data());
+
+    WGPUBufferDescriptor staging_descriptor = {
+        .label = "bench_staging",
+        .usage = WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst,
+        .size = param,
+    };
+    WGPUBuffer staging = wgpuDeviceCreateBuffer(bench->device, &staging_descriptor);
+    wgpuQueueSubmit(bench->queue, 0, nullptr);
+    wait_idle(bench);
+
+    auto start = std::chrono::steady_clock::now();
+
+    WGPUCommandEncoder command_encoder = wgpuDeviceCreateCommandEncoder(bench->device, nullptr);
+    wgpuCommandEncoderCopyBufferToBuffer(command_encoder, source, 0, staging, 0, param);
+    WGPUCommandBuffer command_buffer = wgpuCommandEncoderFinish(command_encoder, nullptr);
+    wgpuQueueSubmit(bench->queue, 1, &command_buffer);
+
+    auto map_status = (WGPUBufferMapAsyncStatus)-1;
+    wgpuBufferMapAsync(staging, WGPUMapMode_Read, 0, param, handle_buffer_map, &map_status);
+    while (map_status == (WGPUBufferMapAsyncStatus)-1) {
+        wait_idle(bench);
+    }
+
+    uint64_t checksum = 0;
+    if (map_status == WGPUBufferMapAsyncStatus_Success) {
+        auto mapped = (const uint8_t*)wgpuBufferGetConstMappedRange(staging, 0, param);
+        // Touch every page so the copy out of the mapping is part of the measurement.
+        for (uint64_t i = 0; i < param; i += 4096) {
+            checksum += mapped[i];
+        }
+        wgpuBufferUnmap(staging);
+    } else {
+        bench->errors++;
+    }
+
+    double us = elapsed_us(start);
+    if (checksum == 0) {
+        bench->errors++;
+    }
+
+    wgpuCommandBufferRelease(command_buffer);
+    wgpuCommandEncoderRelease(command_encoder);
+    wgpuBufferDestroy(staging);
+    wgpuBufferRelease(staging);
+    wgpuBufferDestroy(source);
+    wgpuBufferRelease(source);
+    return us;
+}
+
+static const Scenario scenarios[] = {
+    {"draw_calls_100", run_draw_calls, 100, 100, "draws/s"},
+    {"draw_calls_1000", run_draw_calls, 1000, 1000, "draws/s"},
+    {"draw_calls_10000", run_draw_calls, 10000, 10000, "draws/s"},
+    {"encoder_finish", run_encoder_finish, 0, 1, "encoders/s"},
+    {"write_buffer_4k", run_write_buffer, 4 << 10, 4 << 10, "bytes/s"},
+    {"write_buffer_64k", run_write_buffer, 64 << 10, 64 << 10, "bytes/s"},
+    {"write_buffer_1m", run_write_buffer, 1 << 20, 1 << 20, "bytes/s"},
+    {"write_buffer_16m", run_write_buffer, 16 << 20, 16 << 20, "bytes/s"},
+    {"create_buffer_4k", run_create_buffer, 4 << 10, 4 << 10, "bytes/s"},
+    {"create_buffer_64k", run_create_buffer, 64 << 10, 64 << 10, "bytes/s"},
+    {"create_buffer_1m", run_create_buffer, 1 << 20, 1 << 20, "bytes/s"},
+    {"create_buffer_16m", run_create_buffer, 16 << 20, 16 << 20, "bytes/s"},
+    {"shader_module_create", run_shader_module_create, 0, 0, nullptr},
+    {"pipeline_create", run_pipeline_create, 0, 0, nullptr},
+    {"readback_4k", run_readback, 4 << 10, 4 << 10, "bytes/s"},
+    {"readback_1m", run_readback, 1 << 20, 1 << 20, "bytes/s"},
+    {"readback_16m", run_readback, 16 << 20, 16 << 20, "bytes/s"},
+};
+
+//-----------------
+// Statistics
+//-----------------
+
+/// Nearest-rank percentile of sorted samples.
+static double percentile(const std::vector<double>& sorted, double p) {
+    size_t rank = (size_t)std::ceil(p / 100.0 * (double)sorted.size());
+    return sorted[std::clamp(rank, (size_t)1, sorted.size()) - 1];
+}
+
+static Result run_scenario(Bench* bench, const Scenario& scenario, int warmup, int repetitions) {
+    for (int i = 0; i < warmup; i++) {
+        scenario.run(bench, scenario.param);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(repetitions);
+    for (int i = 0; i < repetitions; i++) {
+        samples.push_back(scenario.run(bench, scenario.param));
+    }
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+
+    Result result = {
+        .name = scenario.name,
+        .min = samples.front(),
+        .p50 = percentile(samples, 50),
+        .p90 = percentile(samples, 90),
+        .p99 = percentile(samples, 99),
+        .max = samples.back(),
+        .mean = sum / (double)samples.size(),
+        .throughput = 0,
+        .throughput_unit = scenario.work_unit,
+    };
+    if (scenario.work > 0) {
+        result.throughput = scenario.work / (result.p50 * 1e-6);
+    }
+    return result;
+}
+
+/// One scenario per line, so that `read_results` does not need a full JSON parser.
+static void write_results(FILE* output, const std::vector<Result>& results, bool fallback, int warmup, int repetitions) {
+    fprintf(output, "{\n");
+    fprintf(output, "  \"adapter\": \"%s\",\n", fallback ? "fallback" : "default");
+    fprintf(output, "  \"warmup\": %d,\n", warmup);
+    fprintf(output, "  \"repetitions\": %d,\n", repetitions);
+    fprintf(output, "  \"unit\": \"us\",\n");
+    fprintf(output, "  \"scenarios\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        fprintf(output,
+                "    {\"name\": \"%s\", \"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f, "
+                "\"mean\": %.3f",
+                result.name.c_str(),
+                result.min,
+                result.p50,
+                result.p90,
+                result.p99,
+                result.max,
+                result.mean);
+        if (result.throughput_unit) {
+            fprintf(output,
+                    ", \"throughput\": %.1f, \"throughput_unit\": \"%s\"",
+                    result.throughput,
+                    result.throughput_unit);
+        }
+        fprintf(output, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(output, "  ]\n");
+    fprintf(output, "}\n");
+}
+
+static bool read_number(const char* line, const char* key, double* value) {
+    const char* found = strstr(line, key);
+    if (!found) {
+        return false;
+    }
+    *value = strtod(found + strlen(key), nullptr);
+    return true;
+}
+
+/// Reads the scenarios written by `write_results`.
+static bool read_results(const char* path, std::vector<Result>* results) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+
+    char line[1024];
+    while (fgets(line, sizeof(line), file)) {
+        const char* name = strstr(line, "\"name\": \"");
+        if (!name) {
+            continue;
+        }
+        name += strlen("\"name\": \"");
+        const char* name_end = strchr(name, '"');
+        if (!name_end) {
+            continue;
+        }
+
+        Result result = {};
+        result.name.assign(name, name_end - name);
+        bool ok = read_number(line, "\"p50\": ", &result.p50) && read_number(line, "\"p90\": ", &result.p90);
+        if (ok) {
+            results->push_back(result);
+        }
+    }
+
+    fclose(file);
+    if (results->empty()) {
+        fprintf(stderr, "no scenarios in %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+static int compare(const char* baseline_path, const char* current_path, double threshold, double min_delta) {
+    std::vector<Result> baseline, current;
+    if (!read_results(baseline_path, &baseline) || !read_results(current_path, &current)) {
+        return 2;
+    }
+
+    int regressions = 0;
+    printf("%-24s %12s %12s %9s  %s\n", "scenario", "base_p50_us", "curr_p50_us", "change", "status");
+    for (const Result& result : current) {
+        auto base = std::find_if(
+            baseline.begin(), baseline.end(), [&](const Result& other) { return other.name == result.name; });
+        if (base == baseline.end()) {
+            printf("%-24s %12s %12.3f %9s  new\n", result.name.c_str(), "-", result.p50, "-");
+            continue;
+        }
+
+        double delta = result.p50 - base->p50;
+        double change = base->p50 > 0 ? 100.0 * delta / base->p50 : 0.0;
+        const char* status = "ok";
+        if (change > threshold && delta > min_delta) {
+            status = "REGRESSION";
+            regressions++;
+        } else if (change < -threshold && -delta > min_delta) {
+            status = "improved";
+        }
+        printf("%-24s %12.3f %12.3f %+8.1f%%  %s\n", result.name.c_str(), base->p50, result.p50, change, status);
+    }
+    for (const Result& result : baseline) {
+        auto found = std::find_if(
+            current.begin(), current.end(), [&](const Result& other) { return other.name == result.name; });
+        if (found == current.end()) {
+            printf("%-24s %12.3f %12s %9s  missing\n", result.name.c_str(), result.p50, "-", "-");
+        }
+    }
+
+    if (regressions) {
+        printf("%d scenario(s) regressed by more than %.1f%%\n", regressions, threshold);
+        return 1;
+    }
+    return 0;
+}
+
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [--scenario SUBSTRING] [--warmup N] [--repetitions N] [--output FILE] [--hardware] [--list]\n"
+            "       %s --compare BASELINE CURRENT [--threshold PERCENT] [--min-delta US]\n",
+            program,
+            program);
+}
+
+int main(int argc, char* argv[]) {
+    const char* filter = nullptr;
+    const char* output_path = nullptr;
+    const char* baseline_path = nullptr;
+    const char* current_path = nullptr;
+    int warmup = 5;
+    int repetitions = 50;
+    double threshold = 10.0;
+    double min_delta = 5.0;
+    bool force_fallback = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmup = std::max(0, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+            repetitions = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (strcmp(argv[i], "--hardware") == 0) {
+            force_fallback = false;
+        } else if (strcmp(argv[i], "--list") == 0) {
+            for (const Scenario& scenario : scenarios) {
+                printf("%s\n", scenario.name);
+            }
+            return 0;
+        } else if (strcmp(argv[i], "--compare") == 0 && i + 2 < argc) {
+            baseline_path = argv[++i];
+            current_path = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--min-delta") == 0 && i + 1 < argc) {
+            min_delta = atof(argv[++i]);
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (baseline_path) {
+        return compare(baseline_path, current_path, threshold, min_delta);
+    }
+
+    Bench bench = {};
+    if (!bench_init(&bench, force_fallback)) {
+        bench_shutdown(&bench);
+        return 2;
+    }
+
+    std::vector<Result> results;
+    for (const Scenario& scenario : scenarios) {
+        if (filter && !strstr(scenario.name, filter)) {
+            continue;
+        }
+        results.push_back(run_scenario(&bench, scenario, warmup, repetitions));
+        // Progress on stderr, stdout may carry the JSON.
+        fprintf(stderr, "%-24s p50=%10.3fus p99=%10.3fus\n", scenario.name, results.back().p50, results.back().p99);
+    }
+
+    bench_shutdown(&bench);
+
+    FILE* output = stdout;
+    if (output_path) {
+        output = fopen(output_path, "w");
+        if (!output) {
+            fprintf(stderr, "cannot open %s\n", output_path);
+            return 2;
+        }
+    }
+    write_results(output, results, force_fallback, warmup, repetitions);
+    if (output != stdout) {
+        fclose(output);
+    }
+
+    if (bench.errors) {
+        fprintf(stderr, "%u GPU errors during the run, results are not valid\n", bench.errors);
+        return 1;
+    }
+    return 0;
+}
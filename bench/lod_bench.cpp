@@ -0,0 +1,235 @@
+// Builds a LOD chain for a test mesh and flies a camera through a large scene of instances of it, reporting the
+// triangles submitted per frame with and without LOD selection, and how often objects switch LOD with and without
+// hysteresis. The visible instances are queued and sorted through `DrawQueue` like a renderer would.
+//
+// Usage: lod_bench [--objects N] [--frames N] [--threshold PIXELS]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../src/culling.h"
+#include "../src/draw_queue.h"
+#include "../src/mesh.h"
+#include "../src/mesh_lod.h"
+#include "../src/thread_pool.h"
+
+struct Instance {
+    vec3 position;
+    float scale;
+};
+
+/// Triangles of `lod` that span more than half of the texture's u range. `make_sphere` puts `segments + 1` vertices
+/// on every ring, and the column of a vertex is its u coordinate, so these are triangles that joined vertices from
+/// both sides of the seam. Any such triangle would smear the whole texture across the mesh.
+static uint32_t count_seam_crossings(const Mesh& mesh, const MeshLod& lod, uint32_t segments) {
+    uint32_t crossings = 0;
+    for (uint32_t i = lod.first_index; i < lod.first_index + lod.index_count; i += 3) {
+        uint32_t min_column = segments, max_column = 0;
+        for (uint32_t k = 0; k < 3; k++) {
+            uint32_t column = mesh.indices[i + k] % (segments + 1);
+            min_column = std::min(min_column, column);
+            max_column = std::max(max_column, column);
+        }
+        crossings += max_column - min_column > segments / 2;
+    }
+    return crossings;
+}
+
+struct FrameTotals {
+    double triangles;
+    double max_triangles;
+    double switches;
+};
+
+int main(int argc, char* argv[]) {
+    uint32_t object_count = 20000;
+    uint32_t frame_count = 600;
+    float threshold = 1.0f;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--objects") == 0 && i + 1 < argc) {
+            object_count = (uint32_t)std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frame_count = (uint32_t)std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = (float)atof(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--objects N] [--frames N] [--threshold PIXELS]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    const uint32_t segments = 128;
+    Mesh mesh;
+    make_sphere(&mesh, segments, segments / 2, 0.15f);
+
+    auto build_start = std::chrono::steady_clock::now();
+    build_lod_chain(&mesh);
+    auto build_end = std::chrono::steady_clock::now();
+
+    printf("LOD chain built in %.1f ms\n", std::chrono::duration<double, std::milli>(build_end - build_start).count());
+    printf("%5s %10s %10s %10s\n", "lod", "triangles", "error", "seam");
+    uint32_t seam_crossings = 0;
+    for (size_t i = 0; i < mesh.lods.size(); i++) {
+        uint32_t crossings = count_seam_crossings(mesh, mesh.lods[i], segments);
+        seam_crossings += crossings;
+        printf("%5zu %10u %10.5f %10u\n", i, mesh.lods[i].index_count / 3, mesh.lods[i].error, crossings);
+    }
+    if (seam_crossings) {
+        fprintf(stderr, "error: %u triangles cross the texture seam\n", seam_crossings);
+    }
+
+    // Instances scattered over a large, flat area.
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> size(0.5f, 5.0f);
+
+    std::vector<Instance> instances(object_count);
+    CullingBounds bounds;
+    for (Instance& instance : instances) {
+        instance.position[0] = position(rng);
+        instance.position[1] = 0.0f;
+        instance.position[2] = position(rng);
+        instance.scale = size(rng);
+
+        float radius = mesh.radius * instance.scale;
+        vec3 extents = {radius, radius, radius};
+        bounds.add(instance.position, extents, radius);
+    }
+
+    const float fovy = 60.0f * 3.14159265f / 180.0f;
+    const float viewport_height = 1080.0f;
+    const float far_plane = 3000.0f;
+
+    mat4x4 projection;
+    mat4x4_perspective(projection, fovy, 16.0f / 9.0f, 0.1f, far_plane);
+
+    LodSelection selection = {
+        .projection_scale = lod_projection_scale(fovy, viewport_height),
+        .threshold_pixels = threshold,
+    };
+    LodSelection no_hysteresis = selection;
+    no_hysteresis.hysteresis = 0.0f;
+
+    ThreadPool pool;
+    FrustumCuller culler;
+    std::vector<uint32_t> visible;
+    DrawQueue draw_queue;
+    // One draw per instance, only the visible ones are filled in and submitted.
+    std::vector<DrawItem> draws(object_count, DrawItem{.instance_count = 1});
+
+    std::vector<uint8_t> current_lods(object_count, 0);
+    std::vector<uint8_t> current_lods_no_hysteresis(object_count, 0);
+
+    FrameTotals full = {}, lod = {}, lod_no_hysteresis = {};
+    double selection_ms = 0.0;
+    double queue_ms = 0.0;
+    double visible_total = 0.0;
+
+    for (uint32_t frame = 0; frame < frame_count; frame++) {
+        // Slow flight across the scene with a slight bob, so objects drift through the switching distances.
+        float t = (float)frame / (float)frame_count;
+        vec3 eye = {-900.0f + 1800.0f * t, 3.0f + 2.0f * sinf(t * 40.0f), -900.0f + 1800.0f * t};
+        vec3 center = {eye[0] + 100.0f, 0.0f, eye[2] + 100.0f};
+        vec3 up = {0.0f, 1.0f, 0.0f};
+
+        mat4x4 view, view_projection;
+        mat4x4_look_at(view, eye, center, up);
+        mat4x4_mul(view_projection, projection, view);
+
+        Frustum frustum;
+        frustum_from_view_projection(&frustum, view_projection);
+        culler.cull(bounds, frustum, &pool, &visible);
+        visible_total += (double)visible.size();
+
+        double frame_full = 0.0, frame_lod = 0.0, frame_lod_no_hysteresis = 0.0;
+        uint32_t switches = 0, switches_no_hysteresis = 0;
+
+        auto selection_start = std::chrono::steady_clock::now();
+        for (uint32_t index : visible) {
+            const Instance& instance = instances[index];
+            float dx = instance.position[0] - eye[0];
+            float dy = instance.position[1] - eye[1];
+            float dz = instance.position[2] - eye[2];
+            float distance = sqrtf(dx * dx + dy * dy + dz * dz) - mesh.radius * instance.scale;
+
+            uint32_t selected = select_lod(
+                mesh.lods.data(), mesh.lods.size(), instance.scale, distance, selection, current_lods[index]);
+            switches += selected != current_lods[index];
+            current_lods[index] = (uint8_t)selected;
+
+            DrawItem& draw = draws[index];
+            draw.count = mesh.lods[selected].index_count;
+            draw.first = mesh.lods[selected].first_index;
+            draw.depth = distance / far_plane;
+
+            selected = select_lod(mesh.lods.data(),
+                                  mesh.lods.size(),
+                                  instance.scale,
+                                  distance,
+                                  no_hysteresis,
+                                  current_lods_no_hysteresis[index]);
+            switches_no_hysteresis += selected != current_lods_no_hysteresis[index];
+            current_lods_no_hysteresis[index] = (uint8_t)selected;
+            frame_lod_no_hysteresis += mesh.lods[selected].index_count / 3;
+
+            frame_full += mesh.lods[0].index_count / 3;
+        }
+        auto selection_end = std::chrono::steady_clock::now();
+        selection_ms += std::chrono::duration<double, std::milli>(selection_end - selection_start).count();
+
+        draw_queue.reset();
+        draw_queue.submit(draws.data(), visible);
+        draw_queue.sort();
+        queue_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - selection_end).count();
+
+        for (uint32_t index : visible) {
+            frame_lod += draws[index].count / 3;
+        }
+
+        // The first frame switches everything from LOD 0, it says nothing about popping.
+        if (frame == 0) {
+            switches = switches_no_hysteresis = 0;
+        }
+
+        full.triangles += frame_full;
+        full.max_triangles = std::max(full.max_triangles, frame_full);
+        lod.triangles += frame_lod;
+        lod.max_triangles = std::max(lod.max_triangles, frame_lod);
+        lod.switches += switches;
+        lod_no_hysteresis.triangles += frame_lod_no_hysteresis;
+        lod_no_hysteresis.max_triangles = std::max(lod_no_hysteresis.max_triangles, frame_lod_no_hysteresis);
+        lod_no_hysteresis.switches += switches_no_hysteresis;
+    }
+
+    double frames = (double)frame_count;
+    printf("\n%u objects, %.0f visible per frame on average, %u frames, threshold %.2f px\n",
+           object_count,
+           visible_total / frames,
+           frame_count,
+           threshold);
+    printf("%-20s %16s %16s %16s\n", "", "avg_tris/frame", "max_tris/frame", "switches/frame");
+    printf("%-20s %16.0f %16.0f %16s\n", "no lod", full.triangles / frames, full.max_triangles, "-");
+    printf("%-20s %16.0f %16.0f %16.1f\n",
+           "lod",
+           lod.triangles / frames,
+           lod.max_triangles,
+           lod.switches / frames);
+    printf("%-20s %16.0f %16.0f %16.1f\n",
+           "lod, no hysteresis",
+           lod_no_hysteresis.triangles / frames,
+           lod_no_hysteresis.max_triangles,
+           lod_no_hysteresis.switches / frames);
+    printf("triangle reduction %.1fx, selection %.3f ms per frame (both variants), draw queue %.3f ms per frame\n",
+           full.triangles / std::max(lod.triangles, 1.0),
+           selection_ms / frames,
+           queue_ms / frames);
+
+    return seam_crossings ? 1 : 0;
+}
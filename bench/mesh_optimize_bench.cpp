@@ -0,0 +1,206 @@
+// Runs the mesh import optimizations (vertex cache, overdraw and vertex fetch ordering) over a set of meshes
+// with LOD chains whose triangles and vertices arrive in random order, reporting ACMR/ATVR before and after and
+// the optimization time over thread counts.
+//
+// With --gpu the meshes go through `import_meshes` instead, which also uploads them to buffers on a headless
+// device of the default adapter, and the timings include the upload.
+//
+// Usage: mesh_optimize_bench [--meshes N] [--max-threads N] [--gpu]
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../src/common.h"
+#include "../src/mesh.h"
+#include "../src/mesh_lod.h"
+#include "../src/mesh_optimize.h"
+#include "../src/thread_pool.h"
+
+#define LOG_PREFIX "[WGPU]"
+
+struct GpuContext {
+    WGPUInstance instance;
+    WGPUAdapter adapter;
+    WGPUDevice device;
+    WGPUQueue queue;
+};
+
+static void handle_request_adapter(WGPURequestAdapterStatus status,
+                                   WGPUAdapter adapter,
+                                   char const* message,
+                                   void* userdata) {
+    if (status == WGPURequestAdapterStatus_Success) {
+        auto context = (GpuContext*)userdata;
+        context->adapter = adapter;
+    } else {
+        fprintf(stderr, LOG_PREFIX " request_adapter status=%#.8x message=%s\n", status, message);
+    }
+}
+
+static void handle_request_device(WGPURequestDeviceStatus status,
+                                  WGPUDevice device,
+                                  char const* message,
+                                  void* userdata) {
+    if (status == WGPURequestDeviceStatus_Success) {
+        auto context = (GpuContext*)userdata;
+        context->device = device;
+    } else {
+        fprintf(stderr, LOG_PREFIX " request_device status=%#.8x message=%s\n", status, message);
+    }
+}
+
+static bool gpu_init(GpuContext* context) {
+    context->instance = wgpuCreateInstance(nullptr);
+    assert(context->instance);
+
+    wgpuInstanceRequestAdapter(context->instance, nullptr, handle_request_adapter, context);
+    if (!context->adapter) {
+        return false;
+    }
+
+    wgpuAdapterRequestDevice(context->adapter, nullptr, handle_request_device, context);
+    if (!context->device) {
+        return false;
+    }
+
+    context->queue = wgpuDeviceGetQueue(context->device);
+    assert(context->queue);
+    return true;
+}
+
+static void gpu_shutdown(GpuContext* context) {
+    wgpuQueueRelease(context->queue);
+    wgpuDeviceRelease(context->device);
+    wgpuAdapterRelease(context->adapter);
+    wgpuInstanceRelease(context->instance);
+}
+
+/// Shuffles the triangles of every LOD and the vertex order, like a mesh exported without any care.
+static void scramble(Mesh* mesh, std::mt19937* rng) {
+    for (const MeshLod& lod : mesh->lods) {
+        uint32_t* indices = mesh->indices.data() + lod.first_index;
+        std::vector<uint32_t> order(lod.index_count / 3);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), *rng);
+
+        std::vector<uint32_t> shuffled(lod.index_count);
+        for (size_t i = 0; i < order.size(); i++) {
+            std::copy(indices + order[i] * 3, indices + order[i] * 3 + 3, shuffled.begin() + i * 3);
+        }
+        std::copy(shuffled.begin(), shuffled.end(), indices);
+    }
+
+    std::vector<uint32_t> permutation(mesh->vertices.size());
+    std::iota(permutation.begin(), permutation.end(), 0);
+    std::shuffle(permutation.begin(), permutation.end(), *rng);
+
+    std::vector<MeshVertex> vertices(mesh->vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        vertices[permutation[i]] = mesh->vertices[i];
+    }
+    mesh->vertices = std::move(vertices);
+    for (uint32_t& index : mesh->indices) {
+        index = permutation[index];
+    }
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t mesh_count = 64;
+    uint32_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    bool gpu = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--meshes") == 0 && i + 1 < argc) {
+            mesh_count = (uint32_t)std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+            max_threads = (uint32_t)std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--gpu") == 0) {
+            gpu = true;
+        } else {
+            fprintf(stderr, "usage: %s [--meshes N] [--max-threads N] [--gpu]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<uint32_t> resolution(16, 160);
+
+    std::vector<Mesh> source(mesh_count);
+    size_t triangle_count = 0;
+    for (Mesh& mesh : source) {
+        uint32_t segments = resolution(rng);
+        make_sphere(&mesh, segments, segments / 2 + 2, 0.15f);
+        build_lod_chain(&mesh);
+        scramble(&mesh, &rng);
+        triangle_count += mesh.indices.size() / 3;
+    }
+
+    std::vector<uint32_t> thread_counts;
+    for (uint32_t threads = 1; threads < max_threads; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    GpuContext context = {};
+    if (gpu && !gpu_init(&context)) {
+        fprintf(stderr, "no GPU device available\n");
+        return 1;
+    }
+
+    std::vector<MeshOptimizeStats> stats;
+    std::vector<GpuMesh> gpu_meshes;
+
+    printf("%u meshes, %zu triangles over all LODs%s\n", mesh_count, triangle_count, gpu ? ", uploaded" : "");
+    printf("%8s %10s %14s\n", "threads", "ms", "triangles/ms");
+    for (uint32_t threads : thread_counts) {
+        std::vector<Mesh> meshes = source;
+        ThreadPool pool(threads);
+
+        auto start = std::chrono::steady_clock::now();
+        if (gpu) {
+            import_meshes(context.device, context.queue, meshes, &pool, &gpu_meshes, &stats);
+            wgpuDevicePoll(context.device, true, nullptr);
+        } else {
+            optimize_meshes(meshes, &pool, &stats);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        printf("%8u %10.2f %14.0f\n", threads, ms, (double)triangle_count / ms);
+
+        for (GpuMesh& gpu_mesh : gpu_meshes) {
+            release_mesh(&gpu_mesh);
+        }
+    }
+
+    // Triangle-weighted averages over LOD 0 of every mesh.
+    double weight = 0.0;
+    double acmr_before = 0.0, acmr_after = 0.0, atvr_before = 0.0, atvr_after = 0.0;
+    for (size_t i = 0; i < source.size(); i++) {
+        double triangles = (double)source[i].lods[0].index_count / 3.0;
+        weight += triangles;
+        acmr_before += triangles * stats[i].before.acmr;
+        acmr_after += triangles * stats[i].after.acmr;
+        atvr_before += triangles * stats[i].before.atvr;
+        atvr_after += triangles * stats[i].after.atvr;
+    }
+
+    printf("\n%8s %8s %8s\n", "", "acmr", "atvr");
+    printf("%8s %8.3f %8.3f\n", "before", acmr_before / weight, atvr_before / weight);
+    printf("%8s %8.3f %8.3f\n", "after", acmr_after / weight, atvr_after / weight);
+
+    if (gpu) {
+        printf("\n%.1f MiB uploaded per run\n", (double)uploaded_bytes() / (1024.0 * 1024.0) / thread_counts.size());
+        gpu_shutdown(&context);
+    }
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include "async_logger.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstring>
+
+static const char* level_name(LogLevel level) {
+    switch (level) {
+        case LogLevel_Off:
+            break;
+        case LogLevel_Error:
+            return "error";
+        case LogLevel_Warn:
+            return "warn";
+        case LogLevel_Info:
+            return "info";
+        case LogLevel_Debug:
+            return "debug";
+        case LogLevel_Trace:
+            return "trace";
+    }
+    return "?";
+}
+
+AsyncLogger::AsyncLogger(FILE* output, size_t capacity) : output(output) {
+    size_t size = 2;
+    while (size < capacity) {
+        size *= 2;
+    }
+
+    slots = std::make_unique<Slot[]>(size);
+    mask = size - 1;
+    for (size_t i = 0; i < size; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    writer = std::thread(&AsyncLogger::writer_loop, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+    stopping.store(true, std::memory_order_release);
+    signal.fetch_add(1, std::memory_order_release);
+    signal.notify_one();
+    writer.join();
+}
+
+void AsyncLogger::log(LogLevel level, const char* format, ...) {
+    if (!enabled(level)) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    enqueue(level, format, args);
+    va_end(args);
+}
+
+void AsyncLogger::log_unfiltered(LogLevel level, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    enqueue(level, format, args);
+    va_end(args);
+}
+
+void AsyncLogger::enqueue(LogLevel level, const char* format, va_list args) {
+    // Claim a slot, or give up right away if the queue is full.
+    Slot* slot;
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+        slot = &slots[pos & mask];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            dropped_count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    vsnprintf(slot->text, sizeof(slot->text), format, args);
+
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    signal.fetch_add(1, std::memory_order_release);
+    signal.notify_one();
+}
+
+bool AsyncLogger::write_one() {
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    Slot* slot = &slots[pos & mask];
+    if (slot->sequence.load(std::memory_order_acquire) != pos + 1) {
+        return false;
+    }
+
+    // Strip the trailing newline most callers (and wgpu) include, one is added below.
+    size_t length = strlen(slot->text);
+    while (length > 0 && slot->text[length - 1] == '\n') {
+        length--;
+    }
+    fprintf(output, "[%s] %.*s\n", level_name(slot->level), (int)length, slot->text);
+
+    slot->sequence.store(pos + mask + 1, std::memory_order_release);
+    dequeue_pos.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+void AsyncLogger::writer_loop() {
+    while (true) {
+        uint32_t observed = signal.load(std::memory_order_acquire);
+
+        bool wrote = false;
+        while (write_one()) {
+            wrote = true;
+        }
+        if (wrote) {
+            fflush(output);
+        }
+
+        if (stopping.load(std::memory_order_acquire)) {
+            // Producers are gone, drain what is left.
+            while (write_one()) {
+            }
+            fflush(output);
+            return;
+        }
+
+        // Returns immediately if anything was logged since `observed` was read.
+        signal.wait(observed, std::memory_order_acquire);
+    }
+}
+
+void AsyncLogger::flush() {
+    size_t target = enqueue_pos.load(std::memory_order_acquire);
+    while (dequeue_pos.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+enum LogLevel : uint32_t {
+    /// Only for `set_level`, discards everything.
+    LogLevel_Off = 0,
+    LogLevel_Error,
+    LogLevel_Warn,
+    LogLevel_Info,
+    LogLevel_Debug,
+    LogLevel_Trace,
+};
+
+#define ASYNC_LOGGER_MESSAGE_SIZE 512
+
+/// Logger that never blocks the caller.
+///
+/// Messages are formatted into a fixed-size slot of a bounded lock-free queue (Vyukov's MPMC ring, used with a
+/// single consumer) and written out by a background thread. When the queue is full the message is dropped and
+/// counted instead of waiting.
+class AsyncLogger {
+public:
+    /// `capacity` is rounded up to a power of two.
+    explicit AsyncLogger(FILE* output = stderr, size_t capacity = 1024);
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    /// Messages above this level are discarded before formatting.
+    void set_level(LogLevel level) {
+        max_level.store(level, std::memory_order_relaxed);
+    }
+
+    bool enabled(LogLevel level) const {
+        return level <= max_level.load(std::memory_order_relaxed);
+    }
+
+#if defined(__GNUC__)
+    __attribute__((format(printf, 3, 4)))
+#endif
+    void log(LogLevel level, const char* format, ...);
+
+    /// Like `log`, without the level check. For messages already filtered at their source, like wgpu's.
+#if defined(__GNUC__)
+    __attribute__((format(printf, 3, 4)))
+#endif
+    void log_unfiltered(LogLevel level, const char* format, ...);
+
+    /// Blocks until everything logged so far has been written. Not for the render thread.
+    void flush();
+
+    uint64_t dropped() const {
+        return dropped_count.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        LogLevel level;
+        char text[ASYNC_LOGGER_MESSAGE_SIZE];
+    };
+
+    void enqueue(LogLevel level, const char* format, va_list args);
+    void writer_loop();
+    bool write_one();
+
+    FILE* output;
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+
+    // Producer and consumer positions on separate cache lines.
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) std::atomic<size_t> dequeue_pos{0};
+    alignas(64) std::atomic<uint32_t> signal{0};
+    std::atomic<uint64_t> dropped_count{0};
+    std::atomic<uint32_t> max_level{LogLevel_Info};
+    std::atomic<bool> stopping{false};
+
+    std::thread writer;
+};
+
+#endif // ASYNC_LOGGER_H
@@ -0,0 +1,167 @@
+#include "bind_group_cache.h"
+
+#include <algorithm>
+
+static void hash_combine(size_t* seed, uint64_t value) {
+    // 64-bit variant of boost::hash_combine.
+    *seed ^= (size_t)(value + 0x9e3779b97f4a7c15ULL + (*seed << 6) + (*seed >> 2));
+}
+
+size_t BindGroupCache::hash_entries(WGPUBindGroupLayout layout, const Entry* entries, size_t count) {
+    size_t seed = 0;
+    hash_combine(&seed, (uint64_t)(uintptr_t)layout);
+    for (size_t i = 0; i < count; i++) {
+        const Entry& entry = entries[i];
+        hash_combine(&seed, entry.binding);
+        hash_combine(&seed, (uint64_t)(uintptr_t)entry.buffer);
+        hash_combine(&seed, entry.offset);
+        hash_combine(&seed, entry.size);
+        hash_combine(&seed, (uint64_t)(uintptr_t)entry.sampler);
+        hash_combine(&seed, (uint64_t)(uintptr_t)entry.texture_view);
+    }
+    return seed;
+}
+
+bool BindGroupCache::Key::matches(WGPUBindGroupLayout other_layout,
+                                  const Entry* other_entries,
+                                  size_t count) const {
+    return layout == other_layout && entries.size() == count &&
+           std::equal(entries.begin(), entries.end(), other_entries);
+}
+
+bool BindGroupCache::Key::references(const void* resource) const {
+    if (layout == resource) {
+        return true;
+    }
+
+    return std::any_of(entries.begin(), entries.end(), [resource](const Entry& entry) {
+        return entry.buffer == resource || entry.sampler == resource || entry.texture_view == resource;
+    });
+}
+
+WGPUBindGroup BindGroupCache::get(WGPUDevice device, const WGPUBindGroupDescriptor& descriptor) {
+    // Only the few entries of this lookup are copied, an owning `Key` is built on a miss.
+    Entry inline_storage[inline_entries];
+    Entry* entries = inline_storage;
+    size_t count = descriptor.entryCount;
+    if (count > inline_entries) {
+        scratch.resize(count);
+        entries = scratch.data();
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const WGPUBindGroupEntry& entry = descriptor.entries[i];
+        entries[i] = Entry{
+            .binding = entry.binding,
+            .buffer = entry.buffer,
+            .offset = entry.offset,
+            .size = entry.size,
+            .sampler = entry.sampler,
+            .texture_view = entry.textureView,
+        };
+    }
+    // The same bind group may be described with entries in any order. They are nearly always already sorted.
+    auto by_binding = [](const Entry& a, const Entry& b) {
+        return a.binding < b.binding;
+    };
+    if (!std::is_sorted(entries, entries + count, by_binding)) {
+        std::sort(entries, entries + count, by_binding);
+    }
+
+    size_t hash = hash_entries(descriptor.layout, entries, count);
+    auto [first, last] = lookup.equal_range(hash);
+    for (auto found = first; found != last; ++found) {
+        if (found->second->key.matches(descriptor.layout, entries, count)) {
+            counters.hits++;
+            lru.splice(lru.begin(), lru, found->second);
+            return found->second->bind_group;
+        }
+    }
+
+    counters.misses++;
+
+    WGPUBindGroup bind_group = wgpuDeviceCreateBindGroup(device, &descriptor);
+    if (!bind_group) {
+        return nullptr;
+    }
+
+    lru.push_front(Node{
+        .key =
+            Key{
+                .layout = descriptor.layout,
+                .entries = std::vector<Entry>(entries, entries + count),
+            },
+        .hash = hash,
+        .bind_group = bind_group,
+    });
+    lookup.emplace(hash, lru.begin());
+
+    if (lru.size() > capacity) {
+        trim(capacity);
+    }
+
+    return bind_group;
+}
+
+void BindGroupCache::erase(std::list<Node>::iterator it) {
+    wgpuBindGroupRelease(it->bind_group);
+    auto [first, last] = lookup.equal_range(it->hash);
+    for (auto found = first; found != last; ++found) {
+        if (found->second == it) {
+            lookup.erase(found);
+            break;
+        }
+    }
+    lru.erase(it);
+}
+
+void BindGroupCache::invalidate(const void* resource) {
+    if (!resource) {
+        return;
+    }
+
+    // Releases are rare compared to lookups, so a linear scan is cheaper than maintaining a reverse index.
+    for (auto it = lru.begin(); it != lru.end();) {
+        auto next = std::next(it);
+        if (it->key.references(resource)) {
+            erase(it);
+            counters.invalidations++;
+        }
+        it = next;
+    }
+}
+
+void BindGroupCache::release(WGPUBuffer buffer) {
+    invalidate(buffer);
+    wgpuBufferRelease(buffer);
+}
+
+void BindGroupCache::release(WGPUTextureView texture_view) {
+    invalidate(texture_view);
+    wgpuTextureViewRelease(texture_view);
+}
+
+void BindGroupCache::release(WGPUSampler sampler) {
+    invalidate(sampler);
+    wgpuSamplerRelease(sampler);
+}
+
+void BindGroupCache::release(WGPUBindGroupLayout layout) {
+    invalidate(layout);
+    wgpuBindGroupLayoutRelease(layout);
+}
+
+void BindGroupCache::trim(size_t max_entries) {
+    while (lru.size() > max_entries) {
+        erase(std::prev(lru.end()));
+        counters.evictions++;
+    }
+}
+
+void BindGroupCache::clear() {
+    for (Node& node : lru) {
+        wgpuBindGroupRelease(node.bind_group);
+    }
+    lookup.clear();
+    lru.clear();
+}
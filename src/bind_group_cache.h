@@ -0,0 +1,109 @@
+#ifndef BIND_GROUP_CACHE_H
+#define BIND_GROUP_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "common.h"
+
+struct BindGroupCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t invalidations;
+
+    double hit_rate() const {
+        uint64_t lookups = hits + misses;
+        return lookups ? (double)hits / (double)lookups : 0.0;
+    }
+};
+
+/// Returns an existing bind group for descriptors that match one seen before.
+///
+/// Descriptors are keyed by their layout and the (binding, buffer, offset, size, sampler, texture view) of every
+/// entry, independent of entry order. Returned bind groups are owned by the cache: do not release them, and
+/// release referenced resources through `release()` (or call `invalidate()` first) so stale entries are dropped.
+/// Like every other WebGPU handle in this code, the cached bind groups are freed explicitly with `clear()`.
+class BindGroupCache {
+public:
+    BindGroupCache() = default;
+    explicit BindGroupCache(size_t capacity) : capacity(capacity) {}
+
+    BindGroupCache(const BindGroupCache&) = delete;
+    BindGroupCache& operator=(const BindGroupCache&) = delete;
+    BindGroupCache(BindGroupCache&&) = default;
+    BindGroupCache& operator=(BindGroupCache&&) = default;
+
+    WGPUBindGroup get(WGPUDevice device, const WGPUBindGroupDescriptor& descriptor);
+
+    /// Drops every cached bind group that references `resource` (a layout, buffer, sampler or texture view).
+    void invalidate(const void* resource);
+
+    void release(WGPUBuffer buffer);
+    void release(WGPUTextureView texture_view);
+    void release(WGPUSampler sampler);
+    void release(WGPUBindGroupLayout layout);
+
+    /// Evicts least recently used bind groups until at most `max_entries` remain.
+    void trim(size_t max_entries);
+
+    void clear();
+
+    size_t size() const {
+        return lru.size();
+    }
+
+    const BindGroupCacheStats& stats() const {
+        return counters;
+    }
+
+    void reset_stats() {
+        counters = {};
+    }
+
+private:
+    struct Entry {
+        uint32_t binding;
+        WGPUBuffer buffer;
+        uint64_t offset;
+        uint64_t size;
+        WGPUSampler sampler;
+        WGPUTextureView texture_view;
+
+        bool operator==(const Entry&) const = default;
+    };
+
+    struct Key {
+        WGPUBindGroupLayout layout;
+        std::vector<Entry> entries;
+
+        bool matches(WGPUBindGroupLayout other_layout, const Entry* other_entries, size_t count) const;
+        bool references(const void* resource) const;
+    };
+
+    struct Node {
+        Key key;
+        size_t hash;
+        WGPUBindGroup bind_group;
+    };
+
+    /// Lookups with at most this many entries are keyed on the stack.
+    static constexpr size_t inline_entries = 8;
+
+    static size_t hash_entries(WGPUBindGroupLayout layout, const Entry* entries, size_t count);
+
+    void erase(std::list<Node>::iterator it);
+
+    size_t capacity = 256;
+    // Most recently used first.
+    std::list<Node> lru;
+    // Keyed by the hash of the descriptor, so that hits can probe without building a `Key`.
+    std::unordered_multimap<size_t, std::list<Node>::iterator> lookup;
+    // Sorted entries of the lookup in progress, when there are more than `inline_entries`.
+    std::vector<Entry> scratch;
+    BindGroupCacheStats counters{};
+};
+
+#endif // BIND_GROUP_CACHE_H
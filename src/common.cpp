@@ -1,9 +1,12 @@
 #include "common.h"
 
+#include <atomic>
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
 
+static std::atomic<uint64_t> total_uploaded_bytes{0};
+
 WGPUShaderModule load_shader_module(WGPUDevice device, const char* name) {
     FILE* file = nullptr;
     char* buf = nullptr;
@@ -85,8 +88,17 @@ WGPUBuffer create_buffer(WGPUDevice device, WGPUQueue queue, size_t size, WGPUBu
 
     WGPUBuffer buffer = wgpuDeviceCreateBuffer(device, &buffer_descriptor);
     if (data) {
-        wgpuQueueWriteBuffer(queue, buffer, 0, data, size);
+        write_buffer(queue, buffer, 0, data, size);
     }
 
     return buffer;
 }
+
+void write_buffer(WGPUQueue queue, WGPUBuffer buffer, uint64_t offset, const void* data, size_t size) {
+    wgpuQueueWriteBuffer(queue, buffer, offset, data, size);
+    total_uploaded_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+uint64_t uploaded_bytes() {
+    return total_uploaded_bytes.load(std::memory_order_relaxed);
+}
@@ -8,6 +8,8 @@
     #include "wgpu.h"
 #endif
 
+#include <cstdint>
+
 WGPUShaderModule load_shader_module(WGPUDevice device, const char* name);
 
 WGPUShaderModule create_shader(WGPUDevice device, const char* code, const char* label);
@@ -18,4 +20,10 @@ WGPUBuffer create_buffer(WGPUDevice device,
                          WGPUBufferUsage usage,
                          const void* data = nullptr);
 
+/// `wgpuQueueWriteBuffer` that also counts the uploaded bytes.
+void write_buffer(WGPUQueue queue, WGPUBuffer buffer, uint64_t offset, const void* data, size_t size);
+
+/// Bytes uploaded through `create_buffer`/`write_buffer` since startup.
+uint64_t uploaded_bytes();
+
 #endif // COMMON_H
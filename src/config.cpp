@@ -0,0 +1,207 @@
+#include "config.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static bool parse_backends(const char* value, WGPUInstanceBackendFlags* backends) {
+    WGPUInstanceBackendFlags flags = 0;
+
+    std::string list = value;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        std::string name = list.substr(start, end - start);
+        start = end + 1;
+
+        if (name == "all") {
+            flags |= WGPUInstanceBackend_All;
+        } else if (name == "vulkan") {
+            flags |= WGPUInstanceBackend_Vulkan;
+        } else if (name == "metal") {
+            flags |= WGPUInstanceBackend_Metal;
+        } else if (name == "dx12") {
+            flags |= WGPUInstanceBackend_DX12;
+        } else if (name == "dx11") {
+            flags |= WGPUInstanceBackend_DX11;
+        } else if (name == "gl") {
+            flags |= WGPUInstanceBackend_GL;
+        } else if (name == "primary") {
+            flags |= WGPUInstanceBackend_Primary;
+        } else if (name == "secondary") {
+            flags |= WGPUInstanceBackend_Secondary;
+        } else {
+            return false;
+        }
+    }
+
+    *backends = flags;
+    return true;
+}
+
+static bool parse_validation(const char* value, ValidationLevel* validation) {
+    if (strcmp(value, "none") == 0) {
+        *validation = Validation_None;
+    } else if (strcmp(value, "basic") == 0) {
+        *validation = Validation_Basic;
+    } else if (strcmp(value, "full") == 0) {
+        *validation = Validation_Full;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static bool parse_log_level(const char* value, WGPULogLevel* log_level) {
+    static const struct {
+        const char* name;
+        WGPULogLevel level;
+    } levels[] = {
+        {"off", WGPULogLevel_Off},
+        {"error", WGPULogLevel_Error},
+        {"warn", WGPULogLevel_Warn},
+        {"info", WGPULogLevel_Info},
+        {"debug", WGPULogLevel_Debug},
+        {"trace", WGPULogLevel_Trace},
+    };
+
+    for (const auto& entry : levels) {
+        if (strcmp(value, entry.name) == 0) {
+            *log_level = entry.level;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parse_flag(const char* value) {
+    return strcmp(value, "1") == 0 || strcmp(value, "true") == 0 || strcmp(value, "on") == 0;
+}
+
+static bool parse_log_level(const char* value, LogLevel* log_level) {
+    WGPULogLevel level;
+    if (!parse_log_level(value, &level)) {
+        return false;
+    }
+    *log_level = to_log_level(level);
+    return true;
+}
+
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [--backend=vulkan,metal,dx12,dx11,gl,primary,secondary,all] [--validation=none|basic|full]\n"
+            "          [--log-level=off|error|warn|info|debug|trace] [--wgpu-log-level=off|error|warn|info|debug|trace]\n"
+            "          [--on-demand] [--overlay] [--bench-frames=N]\n",
+            program);
+}
+
+bool parse_config(AppConfig* config, int argc, char* argv[]) {
+    bool ok = true;
+
+    if (const char* value = getenv("WGPU_DEMO_BACKEND")) {
+        ok &= parse_backends(value, &config->backends);
+    }
+    if (const char* value = getenv("WGPU_DEMO_VALIDATION")) {
+        ok &= parse_validation(value, &config->validation);
+    }
+    if (const char* value = getenv("WGPU_DEMO_LOG_LEVEL")) {
+        ok &= parse_log_level(value, &config->log_level);
+    }
+    if (const char* value = getenv("WGPU_DEMO_WGPU_LOG_LEVEL")) {
+        ok &= parse_log_level(value, &config->wgpu_log_level);
+    }
+    if (const char* value = getenv("WGPU_DEMO_ON_DEMAND")) {
+        config->on_demand = parse_flag(value);
+    }
+    if (const char* value = getenv("WGPU_DEMO_OVERLAY")) {
+        config->overlay = parse_flag(value);
+    }
+
+    for (int i = 1; i < argc && ok; i++) {
+        const char* arg = argv[i];
+
+        if (strncmp(arg, "--backend=", 10) == 0) {
+            ok = parse_backends(arg + 10, &config->backends);
+        } else if (strncmp(arg, "--validation=", 13) == 0) {
+            ok = parse_validation(arg + 13, &config->validation);
+        } else if (strncmp(arg, "--log-level=", 12) == 0) {
+            ok = parse_log_level(arg + 12, &config->log_level);
+        } else if (strncmp(arg, "--wgpu-log-level=", 17) == 0) {
+            ok = parse_log_level(arg + 17, &config->wgpu_log_level);
+        } else if (strncmp(arg, "--bench-frames=", 15) == 0) {
+            config->bench_frames = (uint32_t)strtoul(arg + 15, nullptr, 10);
+            ok = config->bench_frames > 0;
+        } else if (strcmp(arg, "--on-demand") == 0) {
+            config->on_demand = true;
+        } else if (strcmp(arg, "--overlay") == 0) {
+            config->overlay = true;
+        } else {
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        print_usage(argv[0]);
+    }
+    return ok;
+}
+
+WGPUInstanceExtras make_instance_extras(const AppConfig& config) {
+    WGPUInstanceFlags flags = WGPUInstanceFlag_Default;
+    switch (config.validation) {
+        case Validation_None:
+            // Labels are only useful to debuggers, drop them in lean mode.
+            flags = WGPUInstanceFlag_DiscardHalLabels;
+            break;
+        case Validation_Basic:
+            // Backend validation layers.
+            flags = WGPUInstanceFlag_Validation;
+            break;
+        case Validation_Full:
+            // Plus debug info and labels passed to the backend.
+            flags = WGPUInstanceFlag_Validation | WGPUInstanceFlag_Debug;
+            break;
+    }
+
+    return WGPUInstanceExtras{
+        .chain =
+            WGPUChainedStruct{
+                .sType = (WGPUSType)WGPUSType_InstanceExtras,
+            },
+        .backends = config.backends,
+        .flags = flags,
+    };
+}
+
+LogLevel to_log_level(WGPULogLevel level) {
+    switch (level) {
+        case WGPULogLevel_Error:
+            return LogLevel_Error;
+        case WGPULogLevel_Warn:
+            return LogLevel_Warn;
+        case WGPULogLevel_Info:
+            return LogLevel_Info;
+        case WGPULogLevel_Debug:
+            return LogLevel_Debug;
+        case WGPULogLevel_Trace:
+            return LogLevel_Trace;
+        default:
+            return LogLevel_Off;
+    }
+}
+
+const char* validation_name(ValidationLevel validation) {
+    switch (validation) {
+        case Validation_None:
+            return "none";
+        case Validation_Basic:
+            return "basic";
+        case Validation_Full:
+            return "full";
+    }
+    return "?";
+}
@@ -0,0 +1,55 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <cstdint>
+
+#include "async_logger.h"
+#include "common.h"
+
+/// Extra validation and debugging on top of wgpu's own API validation, which is always on.
+enum ValidationLevel {
+    /// No backend validation layers, HAL labels discarded. For production.
+    Validation_None,
+    /// Backend validation layers (Vulkan validation layers, D3D12 debug layer, Metal API validation).
+    Validation_Basic,
+    /// Validation layers plus backend debug info and object labels.
+    Validation_Full,
+};
+
+/// Runtime settings of the native demo. Environment variables are read first, command line options override them.
+///
+/// * `--backend=<list>`, `WGPU_DEMO_BACKEND`: comma separated vulkan, metal, dx12, dx11, gl, primary, secondary, all.
+/// * `--validation=<level>`, `WGPU_DEMO_VALIDATION`: none, basic (backend validation layers) or full (plus debug
+///   info and labels).
+/// * `--log-level=<level>`, `WGPU_DEMO_LOG_LEVEL`: off, error, warn, info, debug, trace. The demo's own messages,
+///   including the periodic frame reports at info.
+/// * `--wgpu-log-level=<level>`, `WGPU_DEMO_WGPU_LOG_LEVEL`: the same levels, for wgpu's messages.
+/// * `--on-demand`, `WGPU_DEMO_ON_DEMAND=1`: only redraw damaged frames.
+/// * `--overlay`, `WGPU_DEMO_OVERLAY=1`: show the performance overlay.
+/// * `--bench-frames=<n>`: render n frames, print the CPU frame cost and exit.
+struct AppConfig {
+    WGPUInstanceBackendFlags backends = WGPUInstanceBackend_All;
+#ifdef NDEBUG
+    ValidationLevel validation = Validation_None;
+#else
+    ValidationLevel validation = Validation_Full;
+#endif
+    LogLevel log_level = LogLevel_Info;
+    WGPULogLevel wgpu_log_level = WGPULogLevel_Warn;
+    bool on_demand = false;
+    bool overlay = false;
+    uint32_t bench_frames = 0;
+};
+
+/// Returns false and prints the usage if an option is not understood.
+bool parse_config(AppConfig* config, int argc, char* argv[]);
+
+/// Instance extras for `config`, chain them into `WGPUInstanceDescriptor::nextInChain`.
+WGPUInstanceExtras make_instance_extras(const AppConfig& config);
+
+/// Level of our own logger matching the wgpu log level.
+LogLevel to_log_level(WGPULogLevel level);
+
+const char* validation_name(ValidationLevel validation);
+
+#endif // CONFIG_H
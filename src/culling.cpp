@@ -0,0 +1,172 @@
+#include "culling.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "thread_pool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CULLING_SSE
+    #include <emmintrin.h>
+#endif
+
+void frustum_from_view_projection(Frustum* frustum, mat4x4 const m) {
+    // linmath matrices are column major, m[column][row].
+    vec4 rows[4];
+    for (int i = 0; i < 4; i++) {
+        mat4x4_row(rows[i], m, i);
+    }
+
+    // Gribb/Hartmann: left, right, bottom, top, near, far.
+    for (int i = 0; i < 3; i++) {
+        vec4_add(frustum->planes[i * 2 + 0], rows[3], rows[i]);
+        vec4_sub(frustum->planes[i * 2 + 1], rows[3], rows[i]);
+    }
+
+    for (auto& plane : frustum->planes) {
+        float length = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        vec4_scale(plane, plane, 1.0f / length);
+    }
+}
+
+uint32_t CullingBounds::add(vec3 const center, vec3 const extents, float sphere_radius) {
+    if (sphere_radius < 0.0f) {
+        sphere_radius = vec3_len(extents);
+    }
+
+    center_x.push_back(center[0]);
+    center_y.push_back(center[1]);
+    center_z.push_back(center[2]);
+    extent_x.push_back(extents[0]);
+    extent_y.push_back(extents[1]);
+    extent_z.push_back(extents[2]);
+    radius.push_back(sphere_radius);
+
+    return (uint32_t)(radius.size() - 1);
+}
+
+void CullingBounds::clear() {
+    center_x.clear();
+    center_y.clear();
+    center_z.clear();
+    extent_x.clear();
+    extent_y.clear();
+    extent_z.clear();
+    radius.clear();
+}
+
+static bool is_visible(const CullingBounds& bounds, const Frustum& frustum, size_t i) {
+    for (const auto& plane : frustum.planes) {
+        float distance = plane[0] * bounds.center_x[i] + plane[1] * bounds.center_y[i] +
+                         plane[2] * bounds.center_z[i] + plane[3];
+        // Projected radius of the box onto the plane normal.
+        float box_radius = fabsf(plane[0]) * bounds.extent_x[i] + fabsf(plane[1]) * bounds.extent_y[i] +
+                           fabsf(plane[2]) * bounds.extent_z[i];
+        if (distance < -std::min(box_radius, bounds.radius[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void cull_scalar(const CullingBounds& bounds,
+                        const Frustum& frustum,
+                        size_t begin,
+                        size_t end,
+                        std::vector<uint32_t>* visible) {
+    for (size_t i = begin; i < end; i++) {
+        if (is_visible(bounds, frustum, i)) {
+            visible->push_back((uint32_t)i);
+        }
+    }
+}
+
+#ifdef CULLING_SSE
+static void cull_sse(const CullingBounds& bounds,
+                     const Frustum& frustum,
+                     size_t begin,
+                     size_t end,
+                     std::vector<uint32_t>* visible) {
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 cx = _mm_loadu_ps(&bounds.center_x[i]);
+        __m128 cy = _mm_loadu_ps(&bounds.center_y[i]);
+        __m128 cz = _mm_loadu_ps(&bounds.center_z[i]);
+        __m128 ex = _mm_loadu_ps(&bounds.extent_x[i]);
+        __m128 ey = _mm_loadu_ps(&bounds.extent_y[i]);
+        __m128 ez = _mm_loadu_ps(&bounds.extent_z[i]);
+        __m128 r = _mm_loadu_ps(&bounds.radius[i]);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const auto& plane : frustum.planes) {
+            __m128 nx = _mm_set1_ps(plane[0]);
+            __m128 ny = _mm_set1_ps(plane[1]);
+            __m128 nz = _mm_set1_ps(plane[2]);
+            __m128 d = _mm_set1_ps(plane[3]);
+
+            __m128 distance =
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_add_ps(_mm_mul_ps(nz, cz), d));
+            __m128 box_radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(sign_mask, nx), ex),
+                                                      _mm_mul_ps(_mm_andnot_ps(sign_mask, ny), ey)),
+                                           _mm_mul_ps(_mm_andnot_ps(sign_mask, nz), ez));
+            __m128 limit = _mm_xor_ps(_mm_min_ps(box_radius, r), sign_mask);
+
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, limit));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        if (mask == 0) {
+            continue;
+        }
+        for (int lane = 0; lane < 4; lane++) {
+            if (mask & (1 << lane)) {
+                visible->push_back((uint32_t)(i + lane));
+            }
+        }
+    }
+
+    cull_scalar(bounds, frustum, i, end, visible);
+}
+#endif
+
+void FrustumCuller::cull(const CullingBounds& bounds,
+                         const Frustum& frustum,
+                         ThreadPool* pool,
+                         std::vector<uint32_t>* visible) {
+    size_t count = bounds.size();
+    size_t task_count = (count + grain - 1) / grain;
+    if (task_visible.size() < task_count) {
+        task_visible.resize(task_count);
+    }
+
+    auto cull_range = [&](size_t begin, size_t end) {
+        std::vector<uint32_t>* output = &task_visible[begin / grain];
+        output->clear();
+#ifdef CULLING_SSE
+        if (simd) {
+            cull_sse(bounds, frustum, begin, end, output);
+            return;
+        }
+#endif
+        cull_scalar(bounds, frustum, begin, end, output);
+    };
+
+    if (pool) {
+        pool->parallel_for(count, grain, cull_range);
+    } else {
+        for (size_t begin = 0; begin < count; begin += grain) {
+            cull_range(begin, std::min(begin + grain, count));
+        }
+    }
+
+    // Tasks cover ascending ranges, so concatenating keeps the output sorted.
+    visible->clear();
+    for (size_t task = 0; task < task_count; task++) {
+        visible->insert(visible->end(), task_visible[task].begin(), task_visible[task].end());
+    }
+
+    counters.tested = (uint32_t)count;
+    counters.visible = (uint32_t)visible->size();
+}
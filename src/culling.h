@@ -0,0 +1,63 @@
+#ifndef CULLING_H
+#define CULLING_H
+
+#include <cstdint>
+#include <vector>
+
+#include <linmath.h>
+
+class ThreadPool;
+
+/// Six normalized planes (a, b, c, d) facing inwards: a point p is inside a plane if dot(abc, p) + d >= 0.
+struct Frustum {
+    float planes[6][4];
+};
+
+/// Extracts the frustum of a view-projection matrix with OpenGL clip depth, as built by `mat4x4_perspective`.
+void frustum_from_view_projection(Frustum* frustum, mat4x4 const view_projection);
+
+/// Object bounds as structure of arrays: an axis-aligned box (center and half extents) and a bounding sphere
+/// around the same center. An object is culled if it is outside either of them.
+struct CullingBounds {
+    std::vector<float> center_x, center_y, center_z;
+    std::vector<float> extent_x, extent_y, extent_z;
+    std::vector<float> radius;
+
+    /// Returns the index of the new object. The sphere defaults to the one enclosing the box.
+    uint32_t add(vec3 const center, vec3 const extents, float sphere_radius = -1.0f);
+
+    void clear();
+
+    size_t size() const {
+        return radius.size();
+    }
+};
+
+struct CullingStats {
+    uint32_t tested;
+    uint32_t visible;
+};
+
+/// Tests bounds against a frustum, 4 objects at a time with SSE where available, split over a thread pool.
+class FrustumCuller {
+public:
+    /// Objects per task. Each task writes its own output so threads never share cache lines.
+    size_t grain = 4096;
+
+    /// Use the vector path. Only turned off to compare against the scalar reference.
+    bool simd = true;
+
+    /// Writes the indices of all objects intersecting `frustum`, in ascending order, to `visible`.
+    /// `pool` may be null to cull on the calling thread.
+    void cull(const CullingBounds& bounds, const Frustum& frustum, ThreadPool* pool, std::vector<uint32_t>* visible);
+
+    const CullingStats& stats() const {
+        return counters;
+    }
+
+private:
+    std::vector<std::vector<uint32_t>> task_visible;
+    CullingStats counters{};
+};
+
+#endif // CULLING_H
@@ -0,0 +1,181 @@
+#include "draw_queue.h"
+
+#include <algorithm>
+#include <array>
+
+static uint64_t pack(uint64_t value, uint32_t bits, uint32_t shift) {
+    return (value & ((1ULL << bits) - 1)) << shift;
+}
+
+uint32_t DrawQueue::id_of(std::unordered_map<const void*, uint32_t>& ids, const void* handle) {
+    // Id 0 is reserved for null handles.
+    if (!handle) {
+        return 0;
+    }
+
+    auto found = ids.find(handle);
+    if (found != ids.end()) {
+        return found->second;
+    }
+
+    uint32_t id = (uint32_t)ids.size() + 1;
+    ids.emplace(handle, id);
+    return id;
+}
+
+uint64_t DrawQueue::make_key(const DrawItem& item) {
+    float depth = std::clamp(item.depth, 0.0f, 1.0f);
+
+    uint64_t key = 0;
+    key |= pack(item.pass, 4, 60);
+    key |= pack(id_of(pipeline_ids, item.pipeline), 10, 50);
+    key |= pack(id_of(bind_group_ids, item.bind_groups[0]), 12, 38);
+    key |= pack(id_of(bind_group_ids, item.bind_groups[1]), 10, 28);
+    key |= pack(id_of(buffer_ids, item.vertex_buffer), 8, 20);
+    key |= pack((uint64_t)(depth * (float)((1 << 20) - 1)), 20, 0);
+    return key;
+}
+
+void DrawQueue::submit(const DrawItem& item) {
+    keys.push_back(make_key(item));
+    order.push_back((uint32_t)items.size());
+    items.push_back(item);
+}
+
+void DrawQueue::submit(const DrawItem* items, const std::vector<uint32_t>& indices) {
+    for (uint32_t index : indices) {
+        submit(items[index]);
+    }
+}
+
+void DrawQueue::sort() {
+    size_t count = keys.size();
+    if (count < 2) {
+        return;
+    }
+
+    // Bytes that are the same in every key do not affect the order, their passes are skipped.
+    uint64_t all_and = ~0ULL;
+    uint64_t all_or = 0;
+    for (uint64_t key : keys) {
+        all_and &= key;
+        all_or |= key;
+    }
+    uint64_t varying = all_and ^ all_or;
+
+    sort_keys.resize(count);
+    sort_order.resize(count);
+
+    // LSD radix sort, 8 bits per pass. Stable, so equal keys keep their submission order.
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        if (((varying >> shift) & 0xFF) == 0) {
+            continue;
+        }
+
+        std::array<uint32_t, 256> offsets = {};
+        for (uint64_t key : keys) {
+            offsets[(key >> shift) & 0xFF]++;
+        }
+
+        uint32_t sum = 0;
+        for (uint32_t& offset : offsets) {
+            uint32_t bucket = offset;
+            offset = sum;
+            sum += bucket;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            uint32_t slot = offsets[(keys[i] >> shift) & 0xFF]++;
+            sort_keys[slot] = keys[i];
+            sort_order[slot] = order[i];
+        }
+
+        keys.swap(sort_keys);
+        order.swap(sort_order);
+    }
+}
+
+void DrawQueue::encode(WGPURenderPassEncoder render_pass, uint32_t pass) {
+    WGPURenderPipeline bound_pipeline = nullptr;
+    std::array<WGPUBindGroup, DRAW_QUEUE_MAX_BIND_GROUPS> bound_bind_groups = {};
+    WGPUBuffer bound_vertex_buffer = nullptr;
+    uint64_t bound_vertex_offset = 0;
+    WGPUBuffer bound_index_buffer = nullptr;
+    WGPUIndexFormat bound_index_format = WGPUIndexFormat_Undefined;
+
+    for (uint32_t index : order) {
+        const DrawItem& item = items[index];
+        if (item.pass != pass) {
+            continue;
+        }
+
+        // What a naive encoder would have set for this draw.
+        uint32_t naive_calls = 1;
+
+        if (item.pipeline != bound_pipeline) {
+            wgpuRenderPassEncoderSetPipeline(render_pass, item.pipeline);
+            bound_pipeline = item.pipeline;
+            counters.pipeline_changes++;
+            naive_calls--;
+        }
+
+        for (uint32_t group = 0; group < DRAW_QUEUE_MAX_BIND_GROUPS; group++) {
+            if (!item.bind_groups[group]) {
+                continue;
+            }
+            naive_calls++;
+            if (item.bind_groups[group] != bound_bind_groups[group]) {
+                wgpuRenderPassEncoderSetBindGroup(render_pass, group, item.bind_groups[group], 0, nullptr);
+                bound_bind_groups[group] = item.bind_groups[group];
+                counters.bind_group_changes++;
+                naive_calls--;
+            }
+        }
+
+        if (item.vertex_buffer) {
+            naive_calls++;
+            if (item.vertex_buffer != bound_vertex_buffer || item.vertex_offset != bound_vertex_offset) {
+                wgpuRenderPassEncoderSetVertexBuffer(
+                    render_pass, 0, item.vertex_buffer, item.vertex_offset, WGPU_WHOLE_SIZE);
+                bound_vertex_buffer = item.vertex_buffer;
+                bound_vertex_offset = item.vertex_offset;
+                counters.vertex_buffer_changes++;
+                naive_calls--;
+            }
+        }
+
+        if (item.index_buffer) {
+            naive_calls++;
+            if (item.index_buffer != bound_index_buffer || item.index_format != bound_index_format) {
+                wgpuRenderPassEncoderSetIndexBuffer(
+                    render_pass, item.index_buffer, item.index_format, 0, WGPU_WHOLE_SIZE);
+                bound_index_buffer = item.index_buffer;
+                bound_index_format = item.index_format;
+                counters.index_buffer_changes++;
+                naive_calls--;
+            }
+
+            wgpuRenderPassEncoderDrawIndexed(
+                render_pass, item.count, item.instance_count, item.first, item.base_vertex, item.first_instance);
+        } else {
+            wgpuRenderPassEncoderDraw(render_pass, item.count, item.instance_count, item.first, item.first_instance);
+        }
+
+        counters.draws++;
+        counters.state_changes_saved += naive_calls;
+    }
+}
+
+void DrawQueue::reset() {
+    items.clear();
+    keys.clear();
+    order.clear();
+    counters = {};
+
+    // Ids are only a sort hint. Start over once handle churn has exhausted the key fields.
+    if (pipeline_ids.size() > 1024 || bind_group_ids.size() > 4096 || buffer_ids.size() > 256) {
+        pipeline_ids.clear();
+        bind_group_ids.clear();
+        buffer_ids.clear();
+    }
+}
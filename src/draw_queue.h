@@ -0,0 +1,91 @@
+#ifndef DRAW_QUEUE_H
+#define DRAW_QUEUE_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "common.h"
+
+#define DRAW_QUEUE_MAX_BIND_GROUPS 2
+
+/// One draw call and the state it needs. Unused bind group slots and buffers are null.
+struct DrawItem {
+    uint32_t pass;
+    WGPURenderPipeline pipeline;
+    WGPUBindGroup bind_groups[DRAW_QUEUE_MAX_BIND_GROUPS];
+    WGPUBuffer vertex_buffer;
+    uint64_t vertex_offset;
+    WGPUBuffer index_buffer;
+    WGPUIndexFormat index_format;
+    /// View depth normalized to [0, 1]. Draws with the same state are ordered front to back.
+    float depth;
+
+    /// Index count for indexed draws, vertex count otherwise.
+    uint32_t count;
+    uint32_t instance_count;
+    /// First index for indexed draws, first vertex otherwise.
+    uint32_t first;
+    int32_t base_vertex;
+    uint32_t first_instance;
+};
+
+struct DrawQueueStats {
+    uint32_t draws;
+    uint32_t pipeline_changes;
+    uint32_t bind_group_changes;
+    uint32_t vertex_buffer_changes;
+    uint32_t index_buffer_changes;
+    /// State calls that were elided compared to setting everything for every draw.
+    uint32_t state_changes_saved;
+};
+
+/// Collects draws for a frame, sorts them by a packed 64-bit state key and records them with redundant
+/// `SetPipeline`/`SetBindGroup`/`SetVertexBuffer`/`SetIndexBuffer` calls removed.
+///
+/// Key layout, most significant first:
+///
+///     | pass:4 | pipeline:10 | bind group 0:12 | bind group 1:10 | vertex buffer:8 | depth:20 |
+///
+/// Handles are mapped to small ids in first-seen order. Ids that overflow their field only make the sort less
+/// effective, the encoder compares the real handles.
+class DrawQueue {
+public:
+    void submit(const DrawItem& item);
+
+    /// Submits `items[indices[i]]` for each index, e.g. the visible list produced by `FrustumCuller`.
+    void submit(const DrawItem* items, const std::vector<uint32_t>& indices);
+
+    /// Sorts everything submitted since the last `reset()`.
+    void sort();
+
+    /// Records the sorted draws of `pass` into `render_pass`. Statistics accumulate until `reset()`.
+    void encode(WGPURenderPassEncoder render_pass, uint32_t pass);
+
+    /// Clears the submitted draws and statistics, keeping the handle ids and scratch memory.
+    void reset();
+
+    const DrawQueueStats& stats() const {
+        return counters;
+    }
+
+private:
+    uint32_t id_of(std::unordered_map<const void*, uint32_t>& ids, const void* handle);
+    uint64_t make_key(const DrawItem& item);
+
+    std::vector<DrawItem> items;
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> order;
+
+    // Radix sort scratch memory.
+    std::vector<uint64_t> sort_keys;
+    std::vector<uint32_t> sort_order;
+
+    std::unordered_map<const void*, uint32_t> pipeline_ids;
+    std::unordered_map<const void*, uint32_t> bind_group_ids;
+    std::unordered_map<const void*, uint32_t> buffer_ids;
+
+    DrawQueueStats counters{};
+};
+
+#endif // DRAW_QUEUE_H
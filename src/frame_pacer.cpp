@@ -0,0 +1,110 @@
+#include "frame_pacer.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+#include <cmath>
+
+void FramePacer::mark_dirty(uint32_t flags) {
+    damage |= flags;
+}
+
+bool FramePacer::has_damage() const {
+    return !on_demand || damage != Damage_None;
+}
+
+bool FramePacer::begin_frame() {
+    start();
+
+    if (on_demand && damage == Damage_None) {
+        // The swap chain still holds the last presented image, so there is nothing to do.
+        return false;
+    }
+
+    damage = Damage_None;
+    frames_rendered++;
+    total_frames_rendered++;
+    return true;
+}
+
+uint64_t FramePacer::total_skipped() const {
+    if (!started) {
+        return 0;
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_wall).count();
+    return skipped_intervals(wall, total_frames_rendered);
+}
+
+void FramePacer::start() {
+    if (started) {
+        return;
+    }
+    started = true;
+    start_wall = std::chrono::steady_clock::now();
+    window_start_wall = start_wall;
+    window_start_cpu = process_cpu_seconds();
+}
+
+uint64_t FramePacer::skipped_intervals(double seconds, uint64_t rendered) const {
+    // Wake-ups without damage are not frames, only the display refreshes that went by without one are.
+    auto intervals = (uint64_t)std::floor(seconds / refresh_interval);
+    return intervals > rendered ? intervals - rendered : 0;
+}
+
+bool FramePacer::poll_report(FrameReport* report) {
+    if (!started) {
+        start();
+        return false;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+
+    double wall = std::chrono::duration<double>(now - window_start_wall).count();
+    if (wall < report_interval) {
+        return false;
+    }
+
+    double cpu = process_cpu_seconds();
+
+    report->frames_rendered = frames_rendered;
+    report->frames_skipped = skipped_intervals(wall, frames_rendered);
+    report->wall_seconds = wall;
+    report->cpu_percent = (cpu - window_start_cpu) / wall * 100.0;
+
+    frames_rendered = 0;
+    window_start_wall = now;
+    window_start_cpu = cpu;
+
+    return true;
+}
+
+double process_cpu_seconds() {
+#ifdef _WIN32
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+        return 0;
+    }
+
+    auto to_seconds = [](FILETIME time) {
+        ULARGE_INTEGER value;
+        value.LowPart = time.dwLowDateTime;
+        value.HighPart = time.dwHighDateTime;
+        // FILETIME counts in 100ns ticks.
+        return (double)value.QuadPart * 1e-7;
+    };
+
+    return to_seconds(kernel_time) + to_seconds(user_time);
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+
+    return (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           (double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+}
@@ -0,0 +1,80 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+#include <cstdint>
+
+/// Reasons a frame has to be redrawn. Anything not covered here keeps showing the last presented image.
+enum DamageFlags : uint32_t {
+    Damage_None = 0,
+    Damage_Input = 1 << 0,
+    Damage_Resize = 1 << 1,
+    Damage_Data = 1 << 2,
+    Damage_Expose = 1 << 3,
+    Damage_All = 0xFFFFFFFF,
+};
+
+/// Statistics for one reporting window.
+struct FrameReport {
+    uint64_t frames_rendered;
+    /// Display refresh intervals in which no frame was rendered.
+    uint64_t frames_skipped;
+    double wall_seconds;
+    /// Process CPU time divided by wall time, in percent of a single core.
+    double cpu_percent;
+};
+
+/// Decides whether the next loop iteration needs to render, and keeps the counters for it.
+///
+/// In continuous mode every iteration renders. In on-demand mode the caller is expected to block in
+/// `glfwWaitEventsTimeout(idle_timeout)` while `has_damage()` is false, and only render once something marked
+/// the scene dirty.
+struct FramePacer {
+    bool on_demand = false;
+    /// Seconds per display refresh, used to count the skipped frames.
+    double refresh_interval = 1.0 / 60.0;
+    /// Upper bound for how long the loop sleeps without any event, in seconds.
+    double idle_timeout = 0.5;
+    /// How often `poll_report` produces a report, in seconds.
+    double report_interval = 5.0;
+
+    void mark_dirty(uint32_t damage);
+
+    bool has_damage() const;
+
+    /// Returns true if this iteration should render a frame, and clears the pending damage.
+    /// Returns false if the previous result is still valid.
+    bool begin_frame();
+
+    /// Fills `report` and starts a new window once `report_interval` has elapsed.
+    bool poll_report(FrameReport* report);
+
+    uint64_t total_rendered() const {
+        return total_frames_rendered;
+    }
+
+    /// Refresh intervals without a rendered frame since the first call to `begin_frame` or `poll_report`.
+    uint64_t total_skipped() const;
+
+private:
+    void start();
+
+    /// Refresh intervals in `seconds` that had no frame, given `rendered` frames.
+    uint64_t skipped_intervals(double seconds, uint64_t rendered) const;
+
+    // The first frame always has to be drawn.
+    uint32_t damage = Damage_All;
+
+    uint64_t frames_rendered = 0;
+    uint64_t total_frames_rendered = 0;
+
+    bool started = false;
+    std::chrono::steady_clock::time_point start_wall;
+    std::chrono::steady_clock::time_point window_start_wall;
+    double window_start_cpu = 0;
+};
+
+/// CPU time consumed by the whole process so far, in seconds.
+double process_cpu_seconds();
+
+#endif // FRAME_PACER_H
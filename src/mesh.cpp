@@ -0,0 +1,142 @@
+#include "mesh.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+void make_sphere(Mesh* mesh, uint32_t segments, uint32_t rings, float noise) {
+    assert(segments >= 3 && rings >= 2);
+
+    mesh->vertices.clear();
+    mesh->indices.clear();
+
+    const float pi = 3.14159265f;
+    for (uint32_t ring = 0; ring <= rings; ring++) {
+        float theta = pi * (float)ring / (float)rings;
+        for (uint32_t segment = 0; segment <= segments; segment++) {
+            float phi = 2.0f * pi * (float)(segment % segments) / (float)segments;
+
+            float x = sinf(theta) * cosf(phi);
+            float y = cosf(theta);
+            float z = sinf(theta) * sinf(phi);
+            // Smooth bumps, identical on both sides of the seam.
+            float r = 1.0f + noise * sinf(5.0f * x + 1.0f) * sinf(7.0f * y + 2.0f) * sinf(3.0f * z + 3.0f);
+
+            mesh->vertices.push_back(MeshVertex{
+                .position = {x * r, y * r, z * r},
+                .normal = {0.0f, 0.0f, 0.0f},
+            });
+        }
+    }
+
+    uint32_t row = segments + 1;
+    for (uint32_t ring = 0; ring < rings; ring++) {
+        for (uint32_t segment = 0; segment < segments; segment++) {
+            uint32_t a = ring * row + segment;
+            uint32_t b = a + 1;
+            uint32_t c = a + row;
+            uint32_t d = c + 1;
+            // The quads touching a pole collapse to a single triangle.
+            if (ring != 0) {
+                mesh->indices.insert(mesh->indices.end(), {a, b, c});
+            }
+            if (ring != rings - 1) {
+                mesh->indices.insert(mesh->indices.end(), {b, d, c});
+            }
+        }
+    }
+
+    // Area-weighted face normals.
+    for (size_t i = 0; i < mesh->indices.size(); i += 3) {
+        MeshVertex& v0 = mesh->vertices[mesh->indices[i + 0]];
+        MeshVertex& v1 = mesh->vertices[mesh->indices[i + 1]];
+        MeshVertex& v2 = mesh->vertices[mesh->indices[i + 2]];
+
+        float e1[3], e2[3];
+        for (int k = 0; k < 3; k++) {
+            e1[k] = v1.position[k] - v0.position[k];
+            e2[k] = v2.position[k] - v0.position[k];
+        }
+        float n[3] = {
+            e1[1] * e2[2] - e1[2] * e2[1],
+            e1[2] * e2[0] - e1[0] * e2[2],
+            e1[0] * e2[1] - e1[1] * e2[0],
+        };
+        for (int k = 0; k < 3; k++) {
+            v0.normal[k] += n[k];
+            v1.normal[k] += n[k];
+            v2.normal[k] += n[k];
+        }
+    }
+    for (MeshVertex& vertex : mesh->vertices) {
+        float length = sqrtf(vertex.normal[0] * vertex.normal[0] + vertex.normal[1] * vertex.normal[1] +
+                             vertex.normal[2] * vertex.normal[2]);
+        if (length > 0.0f) {
+            for (float& n : vertex.normal) {
+                n /= length;
+            }
+        }
+    }
+
+    mesh_reset_lods(mesh);
+}
+
+void mesh_reset_lods(Mesh* mesh) {
+    float min[3] = {INFINITY, INFINITY, INFINITY};
+    float max[3] = {-INFINITY, -INFINITY, -INFINITY};
+    for (const MeshVertex& vertex : mesh->vertices) {
+        for (int k = 0; k < 3; k++) {
+            min[k] = std::min(min[k], vertex.position[k]);
+            max[k] = std::max(max[k], vertex.position[k]);
+        }
+    }
+
+    float radius_squared = 0.0f;
+    for (int k = 0; k < 3; k++) {
+        mesh->center[k] = mesh->vertices.empty() ? 0.0f : 0.5f * (min[k] + max[k]);
+    }
+    for (const MeshVertex& vertex : mesh->vertices) {
+        float dx = vertex.position[0] - mesh->center[0];
+        float dy = vertex.position[1] - mesh->center[1];
+        float dz = vertex.position[2] - mesh->center[2];
+        radius_squared = std::max(radius_squared, dx * dx + dy * dy + dz * dz);
+    }
+    mesh->radius = sqrtf(radius_squared);
+
+    mesh->lods = {
+        MeshLod{
+            .first_index = 0,
+            .index_count = (uint32_t)mesh->indices.size(),
+            .error = 0.0f,
+        },
+    };
+}
+
+GpuMesh upload_mesh(WGPUDevice device, WGPUQueue queue, const Mesh& mesh) {
+    GpuMesh gpu_mesh = {
+        .vertex_buffer = create_buffer(device,
+                                       queue,
+                                       mesh.vertices.size() * sizeof(MeshVertex),
+                                       WGPUBufferUsage_Vertex,
+                                       mesh.vertices.data()),
+        .index_buffer = create_buffer(
+            device, queue, mesh.indices.size() * sizeof(uint32_t), WGPUBufferUsage_Index, mesh.indices.data()),
+        .lods = mesh.lods,
+        .center = {mesh.center[0], mesh.center[1], mesh.center[2]},
+        .radius = mesh.radius,
+    };
+    assert(gpu_mesh.vertex_buffer && gpu_mesh.index_buffer);
+    return gpu_mesh;
+}
+
+void release_mesh(GpuMesh* mesh) {
+    if (mesh->vertex_buffer) {
+        wgpuBufferRelease(mesh->vertex_buffer);
+        mesh->vertex_buffer = nullptr;
+    }
+    if (mesh->index_buffer) {
+        wgpuBufferRelease(mesh->index_buffer);
+        mesh->index_buffer = nullptr;
+    }
+    mesh->lods.clear();
+}
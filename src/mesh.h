@@ -0,0 +1,54 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "common.h"
+
+struct MeshVertex {
+    float position[3];
+    float normal[3];
+};
+
+/// Index range of one level of detail inside the mesh index buffer.
+struct MeshLod {
+    uint32_t first_index;
+    uint32_t index_count;
+    /// Geometric error against LOD 0, in mesh units. Non-decreasing along the chain.
+    float error;
+};
+
+/// Indexed triangle mesh. All LODs share `vertices`; their indices are stored back to back in `indices`, LOD 0
+/// first. A mesh without a LOD chain has a single LOD covering all indices.
+struct Mesh {
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<MeshLod> lods;
+
+    /// Bounding sphere.
+    float center[3];
+    float radius;
+};
+
+/// Mesh in GPU buffers, ready to be drawn with `DrawItem::first`/`count` set from one of `lods`.
+struct GpuMesh {
+    WGPUBuffer vertex_buffer;
+    WGPUBuffer index_buffer;
+    std::vector<MeshLod> lods;
+    float center[3];
+    float radius;
+};
+
+/// Sphere with `segments` x `rings` quads, radially displaced by up to `noise` so that simplification has
+/// something to preserve. The seam and pole vertices are duplicated, as in most imported meshes.
+void make_sphere(Mesh* mesh, uint32_t segments, uint32_t rings, float noise);
+
+/// Recomputes `center`/`radius` from the vertices and resets the LOD chain to a single LOD.
+void mesh_reset_lods(Mesh* mesh);
+
+GpuMesh upload_mesh(WGPUDevice device, WGPUQueue queue, const Mesh& mesh);
+
+void release_mesh(GpuMesh* mesh);
+
+#endif // MESH_H
@@ -0,0 +1,486 @@
+#include "mesh_lod.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+/// Symmetric 4x4 matrix of a sum of squared plane distances, plus the total weight of the planes.
+struct Quadric {
+    double a00, a01, a02, a11, a12, a22;
+    double b0, b1, b2;
+    double c;
+    double weight;
+
+    void add_plane(double nx, double ny, double nz, double d, double w) {
+        a00 += w * nx * nx;
+        a01 += w * nx * ny;
+        a02 += w * nx * nz;
+        a11 += w * ny * ny;
+        a12 += w * ny * nz;
+        a22 += w * nz * nz;
+        b0 += w * nx * d;
+        b1 += w * ny * d;
+        b2 += w * nz * d;
+        c += w * d * d;
+        weight += w;
+    }
+
+    void add(const Quadric& other) {
+        a00 += other.a00;
+        a01 += other.a01;
+        a02 += other.a02;
+        a11 += other.a11;
+        a12 += other.a12;
+        a22 += other.a22;
+        b0 += other.b0;
+        b1 += other.b1;
+        b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+    }
+
+    /// Weighted sum of squared distances from `p` to the planes.
+    double evaluate(const float* p) const {
+        double x = p[0], y = p[1], z = p[2];
+        double result = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                        2.0 * (b0 * x + b1 * y + b2 * z) + c;
+        return std::max(result, 0.0);
+    }
+};
+
+struct Collapse {
+    uint32_t from;
+    uint32_t to;
+    /// Mean squared distance.
+    double cost;
+};
+
+// Border edges count 10 times as much as their triangles, so that silhouettes of open meshes survive.
+const double border_weight = 10.0;
+
+uint64_t edge_key(uint32_t a, uint32_t b) {
+    return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+}
+
+void cross(double* out, const double* a, const double* b) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+void triangle_normal(double* normal, const float* p0, const float* p1, const float* p2) {
+    double e1[3] = {(double)p1[0] - p0[0], (double)p1[1] - p0[1], (double)p1[2] - p0[2]};
+    double e2[3] = {(double)p2[0] - p0[0], (double)p2[1] - p0[1], (double)p2[2] - p0[2]};
+    cross(normal, e1, e2);
+}
+
+/// Maps every vertex to the first vertex with the same position, and counts the vertices of each position.
+void build_position_groups(const MeshVertex* vertices,
+                           size_t vertex_count,
+                           std::vector<uint32_t>* canonical,
+                           std::vector<uint32_t>* group_size) {
+    std::vector<uint32_t> order(vertex_count);
+    for (uint32_t i = 0; i < vertex_count; i++) {
+        order[i] = i;
+    }
+    auto less = [&](uint32_t a, uint32_t b) {
+        const float* pa = vertices[a].position;
+        const float* pb = vertices[b].position;
+        if (pa[0] != pb[0]) {
+            return pa[0] < pb[0];
+        }
+        if (pa[1] != pb[1]) {
+            return pa[1] < pb[1];
+        }
+        if (pa[2] != pb[2]) {
+            return pa[2] < pb[2];
+        }
+        return a < b;
+    };
+    std::sort(order.begin(), order.end(), less);
+
+    canonical->assign(vertex_count, 0);
+    group_size->assign(vertex_count, 0);
+    size_t begin = 0;
+    while (begin < vertex_count) {
+        const float* p = vertices[order[begin]].position;
+        size_t end = begin + 1;
+        while (end < vertex_count && vertices[order[end]].position[0] == p[0] &&
+               vertices[order[end]].position[1] == p[1] && vertices[order[end]].position[2] == p[2]) {
+            end++;
+        }
+        // Sorted by index within the group, the first one represents it.
+        uint32_t representative = order[begin];
+        for (size_t i = begin; i < end; i++) {
+            (*canonical)[order[i]] = representative;
+        }
+        (*group_size)[representative] = (uint32_t)(end - begin);
+        begin = end;
+    }
+}
+
+} // namespace
+
+size_t simplify_mesh(uint32_t* destination,
+                     const uint32_t* indices,
+                     size_t index_count,
+                     const MeshVertex* vertices,
+                     size_t vertex_count,
+                     size_t target_index_count,
+                     float max_error,
+                     float* result_error) {
+    assert(index_count % 3 == 0);
+
+    std::vector<uint32_t> canonical, group_size;
+    build_position_groups(vertices, vertex_count, &canonical, &group_size);
+
+    // Triangles in vertex indices; topology is always looked at through `canonical`.
+    std::vector<uint32_t> triangles(indices, indices + index_count);
+
+    // Border edges are used by a single triangle.
+    std::vector<uint64_t> edges;
+    edges.reserve(index_count);
+    for (size_t i = 0; i < index_count; i += 3) {
+        for (int k = 0; k < 3; k++) {
+            edges.push_back(edge_key(canonical[indices[i + k]], canonical[indices[i + (k + 1) % 3]]));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    std::vector<uint64_t> border_edges;
+    for (size_t i = 0; i < edges.size();) {
+        size_t j = i + 1;
+        while (j < edges.size() && edges[j] == edges[i]) {
+            j++;
+        }
+        if (j - i == 1) {
+            border_edges.push_back(edges[i]);
+        }
+        i = j;
+    }
+    auto is_border_edge = [&](uint32_t a, uint32_t b) {
+        return std::binary_search(border_edges.begin(), border_edges.end(), edge_key(a, b));
+    };
+
+    std::vector<uint8_t> border(vertex_count, 0);
+    for (uint64_t edge : border_edges) {
+        border[edge >> 32] = 1;
+        border[edge & 0xFFFFFFFF] = 1;
+    }
+
+    // Area-weighted face quadrics, plus perpendicular planes along borders.
+    std::vector<Quadric> quadrics(vertex_count, Quadric{});
+    for (size_t i = 0; i < index_count; i += 3) {
+        uint32_t v[3] = {canonical[indices[i]], canonical[indices[i + 1]], canonical[indices[i + 2]]};
+        const float* p[3] = {vertices[v[0]].position, vertices[v[1]].position, vertices[v[2]].position};
+
+        double normal[3];
+        triangle_normal(normal, p[0], p[1], p[2]);
+        double length = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length == 0.0) {
+            continue;
+        }
+        for (double& n : normal) {
+            n /= length;
+        }
+        double area = 0.5 * length;
+        double d = -(normal[0] * p[0][0] + normal[1] * p[0][1] + normal[2] * p[0][2]);
+        for (int k = 0; k < 3; k++) {
+            quadrics[v[k]].add_plane(normal[0], normal[1], normal[2], d, area);
+        }
+
+        for (int k = 0; k < 3; k++) {
+            uint32_t a = v[k], b = v[(k + 1) % 3];
+            if (!is_border_edge(a, b)) {
+                continue;
+            }
+            double edge[3] = {(double)vertices[b].position[0] - vertices[a].position[0],
+                              (double)vertices[b].position[1] - vertices[a].position[1],
+                              (double)vertices[b].position[2] - vertices[a].position[2]};
+            double edge_length_squared = edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2];
+            double plane[3];
+            cross(plane, edge, normal);
+            double plane_length = sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            if (plane_length == 0.0) {
+                continue;
+            }
+            for (double& n : plane) {
+                n /= plane_length;
+            }
+            double plane_d = -(plane[0] * vertices[a].position[0] + plane[1] * vertices[a].position[1] +
+                               plane[2] * vertices[a].position[2]);
+            double w = border_weight * edge_length_squared;
+            quadrics[a].add_plane(plane[0], plane[1], plane[2], plane_d, w);
+            quadrics[b].add_plane(plane[0], plane[1], plane[2], plane_d, w);
+        }
+    }
+
+    auto collapse_cost = [&](uint32_t from, uint32_t to) {
+        Quadric q = quadrics[from];
+        q.add(quadrics[to]);
+        return q.weight > 0.0 ? q.evaluate(vertices[to].position) / q.weight : 0.0;
+    };
+
+    // Only vertices alone at their position move, so seams stay closed.
+    auto can_collapse = [&](uint32_t from, uint32_t to) {
+        if (group_size[from] != 1) {
+            return false;
+        }
+        return !border[from] || is_border_edge(from, to);
+    };
+
+    double max_cost = (double)max_error * (double)max_error;
+    double error = 0.0;
+
+    std::vector<uint32_t> adjacency_offsets, adjacency;
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> collapse_target(vertex_count);
+    std::vector<uint8_t> touched(vertex_count);
+
+    while (triangles.size() > target_index_count) {
+        size_t triangle_count = triangles.size() / 3;
+
+        // Triangles around each position.
+        adjacency_offsets.assign(vertex_count + 1, 0);
+        for (uint32_t index : triangles) {
+            adjacency_offsets[canonical[index] + 1]++;
+        }
+        for (size_t i = 0; i < vertex_count; i++) {
+            adjacency_offsets[i + 1] += adjacency_offsets[i];
+        }
+        adjacency.resize(triangles.size());
+        {
+            std::vector<uint32_t> fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+            for (size_t i = 0; i < triangles.size(); i++) {
+                adjacency[fill[canonical[triangles[i]]]++] = (uint32_t)(i / 3);
+            }
+        }
+
+        // Cheapest direction of every edge.
+        collapses.clear();
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t a = canonical[triangles[i + k]];
+                uint32_t b = canonical[triangles[i + (k + 1) % 3]];
+                // Each interior edge is seen from both triangles, keep one.
+                if (a > b && !is_border_edge(a, b)) {
+                    continue;
+                }
+
+                Collapse best = {0, 0, INFINITY};
+                if (can_collapse(a, b)) {
+                    best = Collapse{a, b, collapse_cost(a, b)};
+                }
+                if (can_collapse(b, a)) {
+                    double cost = collapse_cost(b, a);
+                    if (cost < best.cost) {
+                        best = Collapse{b, a, cost};
+                    }
+                }
+                if (best.cost <= max_cost) {
+                    collapses.push_back(best);
+                }
+            }
+        }
+        if (collapses.empty()) {
+            break;
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) {
+            return a.cost < b.cost;
+        });
+
+        for (size_t i = 0; i < vertex_count; i++) {
+            collapse_target[i] = (uint32_t)i;
+        }
+        std::fill(touched.begin(), touched.end(), 0);
+
+        size_t remaining = triangle_count;
+        size_t applied = 0;
+        for (const Collapse& collapse : collapses) {
+            if (remaining * 3 <= target_index_count) {
+                break;
+            }
+            if (touched[collapse.from] || touched[collapse.to]) {
+                continue;
+            }
+
+            // Reject collapses that flip or degenerate a triangle that survives them.
+            const float* target = vertices[collapse.to].position;
+            bool rejected = false;
+            size_t removed = 0;
+            // The copy of `to` that the triangles around `from` continue into. `from` is not on a seam, so the
+            // triangles removed with the edge all use the copy on this side of any seam through `to`.
+            uint32_t target_vertex = collapse.to;
+            for (uint32_t t = adjacency_offsets[collapse.from]; t < adjacency_offsets[collapse.from + 1]; t++) {
+                const uint32_t* triangle = &triangles[adjacency[t] * 3];
+                uint32_t v[3] = {canonical[triangle[0]], canonical[triangle[1]], canonical[triangle[2]]};
+                if (v[0] == collapse.to || v[1] == collapse.to || v[2] == collapse.to) {
+                    for (int k = 0; k < 3; k++) {
+                        if (v[k] == collapse.to) {
+                            target_vertex = triangle[k];
+                        }
+                    }
+                    removed++;
+                    continue;
+                }
+
+                // A position with more than two copies, like a pole, has a copy per wedge of triangles. Moving
+                // `from` would stretch this wedge towards `to`, across the attributes of the others, so vertices
+                // next to one may only collapse onto it.
+                if (group_size[v[0]] > 2 || group_size[v[1]] > 2 || group_size[v[2]] > 2) {
+                    rejected = true;
+                    break;
+                }
+
+                const float* before[3] = {vertices[v[0]].position, vertices[v[1]].position, vertices[v[2]].position};
+                const float* after[3] = {before[0], before[1], before[2]};
+                for (int k = 0; k < 3; k++) {
+                    if (v[k] == collapse.from) {
+                        after[k] = target;
+                    }
+                }
+
+                double n0[3], n1[3];
+                triangle_normal(n0, before[0], before[1], before[2]);
+                triangle_normal(n1, after[0], after[1], after[2]);
+                double dot = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2];
+                double length0 = n0[0] * n0[0] + n0[1] * n0[1] + n0[2] * n0[2];
+                double length1 = n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2];
+                // Also rejects normals turning by more than ~75 degrees.
+                if (dot <= 0.25 * sqrt(length0 * length1)) {
+                    rejected = true;
+                    break;
+                }
+            }
+            if (rejected) {
+                continue;
+            }
+
+            collapse_target[collapse.from] = target_vertex;
+            quadrics[collapse.to].add(quadrics[collapse.from]);
+            error = std::max(error, collapse.cost);
+            remaining -= removed;
+            applied++;
+
+            // Everything around the collapsed vertex changed shape, leave it for the next pass.
+            for (uint32_t t = adjacency_offsets[collapse.from]; t < adjacency_offsets[collapse.from + 1]; t++) {
+                const uint32_t* triangle = &triangles[adjacency[t] * 3];
+                for (int k = 0; k < 3; k++) {
+                    touched[canonical[triangle[k]]] = 1;
+                }
+            }
+        }
+        if (applied == 0) {
+            break;
+        }
+
+        // Rewrite the triangles and drop the ones that became degenerate.
+        size_t write = 0;
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            uint32_t v[3];
+            for (int k = 0; k < 3; k++) {
+                uint32_t index = triangles[i + k];
+                // A moved vertex is alone at its position, so `index` == its canonical vertex. Its target is
+                // the right copy already, vertices that did not move keep theirs.
+                uint32_t to = collapse_target[canonical[index]];
+                v[k] = to != canonical[index] ? to : index;
+            }
+            if (canonical[v[0]] == canonical[v[1]] || canonical[v[1]] == canonical[v[2]] ||
+                canonical[v[0]] == canonical[v[2]]) {
+                continue;
+            }
+            triangles[write++] = v[0];
+            triangles[write++] = v[1];
+            triangles[write++] = v[2];
+        }
+        triangles.resize(write);
+    }
+
+    std::copy(triangles.begin(), triangles.end(), destination);
+    if (result_error) {
+        *result_error = (float)sqrt(error);
+    }
+    return triangles.size();
+}
+
+void build_lod_chain(Mesh* mesh, const LodChainSettings& settings) {
+    if (mesh->lods.empty()) {
+        mesh_reset_lods(mesh);
+    }
+
+    // Drop any previous chain, LOD 0 stays at the start of the index buffer.
+    MeshLod base = mesh->lods[0];
+    std::vector<uint32_t> source(mesh->indices.begin() + base.first_index,
+                                 mesh->indices.begin() + base.first_index + base.index_count);
+    mesh->indices = source;
+    mesh->lods = {
+        MeshLod{
+            .first_index = 0,
+            .index_count = (uint32_t)source.size(),
+            .error = 0.0f,
+        },
+    };
+
+    std::vector<uint32_t> lod_indices(source.size());
+    float max_error = settings.max_error * mesh->radius;
+    double target = (double)source.size();
+
+    while (mesh->lods.size() < settings.max_lods) {
+        target *= settings.reduction;
+        size_t target_index_count = (size_t)target / 3 * 3;
+        if (target_index_count / 3 < settings.min_triangles) {
+            break;
+        }
+
+        // Every level is simplified from LOD 0, so its error is measured against the original surface.
+        float lod_error = 0.0f;
+        size_t lod_index_count = simplify_mesh(lod_indices.data(),
+                                               source.data(),
+                                               source.size(),
+                                               mesh->vertices.data(),
+                                               mesh->vertices.size(),
+                                               target_index_count,
+                                               max_error,
+                                               &lod_error);
+
+        const MeshLod& previous = mesh->lods.back();
+        if ((double)lod_index_count > 0.9 * (double)previous.index_count) {
+            break;
+        }
+
+        mesh->lods.push_back(MeshLod{
+            .first_index = (uint32_t)mesh->indices.size(),
+            .index_count = (uint32_t)lod_index_count,
+            .error = std::max(lod_error, previous.error),
+        });
+        mesh->indices.insert(mesh->indices.end(), lod_indices.begin(), lod_indices.begin() + lod_index_count);
+    }
+}
+
+float lod_projection_scale(float fovy, float viewport_height) {
+    return viewport_height / (2.0f * tanf(0.5f * fovy));
+}
+
+uint32_t select_lod(const MeshLod* lods,
+                    uint32_t lod_count,
+                    float scale,
+                    float distance,
+                    const LodSelection& selection,
+                    uint32_t current_lod) {
+    assert(lod_count > 0);
+
+    // Error in pixels of a LOD at this distance.
+    float pixels_per_unit = scale * selection.projection_scale / std::max(distance, 1e-3f);
+    auto projected = [&](uint32_t lod) { return lods[lod].error * pixels_per_unit; };
+
+    uint32_t lod = std::min(current_lod, lod_count - 1);
+    while (lod > 0 && projected(lod) > selection.threshold_pixels * (1.0f + selection.hysteresis)) {
+        lod--;
+    }
+    while (lod + 1 < lod_count && projected(lod + 1) <= selection.threshold_pixels * (1.0f - selection.hysteresis)) {
+        lod++;
+    }
+    return lod;
+}
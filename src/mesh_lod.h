@@ -0,0 +1,69 @@
+#ifndef MESH_LOD_H
+#define MESH_LOD_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "mesh.h"
+
+/// Simplifies a triangle list with quadric error metrics (Garland and Heckbert) by collapsing edges onto
+/// existing vertices, so that the result indexes the same vertex buffer.
+///
+/// Collapses run cheapest first until the index count reaches `target_index_count` or the next collapse would
+/// move the surface by more than `max_error` (in mesh units). Vertices on attribute seams (several vertices at the
+/// same position) never move, and a vertex collapsing onto a seam joins the copy on its own side of it. Vertices
+/// next to a position with more than two copies, like the pole of a UV sphere, only collapse onto it. Open borders
+/// only collapse along themselves, and collapses that would flip a triangle are rejected.
+///
+/// Writes at most `index_count` indices to `destination` and returns how many. `result_error`, if not null,
+/// receives the error of the result.
+size_t simplify_mesh(uint32_t* destination,
+                     const uint32_t* indices,
+                     size_t index_count,
+                     const MeshVertex* vertices,
+                     size_t vertex_count,
+                     size_t target_index_count,
+                     float max_error,
+                     float* result_error = nullptr);
+
+struct LodChainSettings {
+    /// Including LOD 0.
+    uint32_t max_lods = 6;
+    /// Target index count of each LOD relative to the previous one.
+    float reduction = 0.5f;
+    /// The chain stops before a LOD would have fewer triangles.
+    uint32_t min_triangles = 32;
+    /// Largest error a LOD may have, relative to the mesh radius.
+    float max_error = 0.25f;
+};
+
+/// Replaces the LODs of `mesh` with a chain simplified from LOD 0, appending their indices to `mesh->indices`.
+/// The chain stops early when a level would no longer remove at least 10% of the triangles.
+void build_lod_chain(Mesh* mesh, const LodChainSettings& settings = {});
+
+struct LodSelection {
+    /// Pixels per unit of size at distance 1, see `lod_projection_scale`.
+    float projection_scale;
+    /// Largest acceptable error on screen, in pixels.
+    float threshold_pixels = 1.0f;
+    /// Fraction of the threshold a LOD has to clear before switching to it, so that objects sitting at a
+    /// switching distance do not flicker between two LODs.
+    float hysteresis = 0.25f;
+};
+
+/// `viewport_height` / (2 tan(`fovy` / 2)), with `fovy` in radians.
+float lod_projection_scale(float fovy, float viewport_height);
+
+/// Picks the coarsest LOD whose error projects to at most `selection.threshold_pixels`, starting from the
+/// LOD selected last frame. `scale` is the object's world scale and `distance` its distance to the camera.
+///
+/// The current LOD is only refined once its error exceeds the threshold by the hysteresis margin, and only
+/// coarsened to a LOD whose error is below the threshold by that margin.
+uint32_t select_lod(const MeshLod* lods,
+                    uint32_t lod_count,
+                    float scale,
+                    float distance,
+                    const LodSelection& selection,
+                    uint32_t current_lod);
+
+#endif // MESH_LOD_H
@@ -0,0 +1,426 @@
+#include "mesh_optimize.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "thread_pool.h"
+
+namespace {
+
+/// FIFO post-transform cache. A vertex is cached if it was last transformed less than `size` misses ago.
+struct CacheSimulator {
+    std::vector<uint32_t> timestamps;
+    uint32_t time;
+    uint32_t size;
+
+    CacheSimulator(size_t vertex_count, uint32_t cache_size) :
+        timestamps(vertex_count, 0), time(cache_size + 1), size(cache_size) {}
+
+    /// Returns true on a miss.
+    bool access(uint32_t vertex) {
+        if (time - timestamps[vertex] > size) {
+            timestamps[vertex] = time++;
+            return true;
+        }
+        return false;
+    }
+
+    /// Evicts everything.
+    void flush() {
+        time += size + 1;
+    }
+};
+
+/// Triangles using each vertex, in compressed rows.
+struct Adjacency {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> triangles;
+
+    Adjacency(const uint32_t* indices, size_t index_count, size_t vertex_count) :
+        offsets(vertex_count + 1, 0), triangles(index_count) {
+        for (size_t i = 0; i < index_count; i++) {
+            offsets[indices[i] + 1]++;
+        }
+        for (size_t i = 0; i < vertex_count; i++) {
+            offsets[i + 1] += offsets[i];
+        }
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < index_count; i++) {
+            triangles[fill[indices[i]]++] = (uint32_t)(i / 3);
+        }
+    }
+};
+
+} // namespace
+
+VertexCacheStats analyze_vertex_cache(const uint32_t* indices,
+                                      size_t index_count,
+                                      size_t vertex_count,
+                                      uint32_t cache_size) {
+    CacheSimulator cache(vertex_count, cache_size);
+    std::vector<uint8_t> referenced(vertex_count, 0);
+
+    size_t misses = 0;
+    size_t unique = 0;
+    for (size_t i = 0; i < index_count; i++) {
+        misses += cache.access(indices[i]);
+        if (!referenced[indices[i]]) {
+            referenced[indices[i]] = 1;
+            unique++;
+        }
+    }
+
+    return VertexCacheStats{
+        .acmr = index_count ? (float)misses / (float)(index_count / 3) : 0.0f,
+        .atvr = unique ? (float)misses / (float)unique : 0.0f,
+    };
+}
+
+void optimize_vertex_cache(uint32_t* destination,
+                           const uint32_t* indices,
+                           size_t index_count,
+                           size_t vertex_count,
+                           uint32_t cache_size,
+                           std::vector<uint32_t>* clusters) {
+    assert(index_count % 3 == 0);
+
+    if (clusters) {
+        clusters->clear();
+    }
+    if (index_count == 0) {
+        return;
+    }
+    assert(destination != indices);
+
+    Adjacency adjacency(indices, index_count, vertex_count);
+
+    // Triangles not emitted yet around each vertex.
+    std::vector<uint32_t> live(vertex_count);
+    for (size_t i = 0; i < vertex_count; i++) {
+        live[i] = adjacency.offsets[i + 1] - adjacency.offsets[i];
+    }
+
+    std::vector<uint32_t> cache_time(vertex_count, 0);
+    uint32_t time = cache_size + 1;
+
+    std::vector<uint8_t> emitted(index_count / 3, 0);
+    std::vector<uint32_t> dead_end;
+    std::vector<uint32_t> candidates;
+    size_t cursor = 0;
+    size_t output = 0;
+
+    // Some vertex with triangles left, from the dead-end stack first, then in input order.
+    auto skip_dead_end = [&]() -> int64_t {
+        while (!dead_end.empty()) {
+            uint32_t vertex = dead_end.back();
+            dead_end.pop_back();
+            if (live[vertex] > 0) {
+                return vertex;
+            }
+        }
+        while (cursor < vertex_count) {
+            if (live[cursor] > 0) {
+                return (int64_t)cursor;
+            }
+            cursor++;
+        }
+        return -1;
+    };
+
+    int64_t fanning = skip_dead_end();
+    if (clusters) {
+        clusters->push_back(0);
+    }
+
+    while (fanning >= 0) {
+        candidates.clear();
+
+        for (uint32_t t = adjacency.offsets[fanning]; t < adjacency.offsets[fanning + 1]; t++) {
+            uint32_t triangle = adjacency.triangles[t];
+            if (emitted[triangle]) {
+                continue;
+            }
+            emitted[triangle] = 1;
+
+            for (int k = 0; k < 3; k++) {
+                uint32_t vertex = indices[triangle * 3 + k];
+                destination[output++] = vertex;
+                dead_end.push_back(vertex);
+                candidates.push_back(vertex);
+                live[vertex]--;
+                if (time - cache_time[vertex] > cache_size) {
+                    cache_time[vertex] = time++;
+                }
+            }
+        }
+
+        // Prefer the candidate that entered the cache earliest among those whose remaining triangles can
+        // still be emitted before it is evicted.
+        int64_t best = -1;
+        int64_t best_priority = -1;
+        for (uint32_t vertex : candidates) {
+            if (live[vertex] == 0) {
+                continue;
+            }
+            int64_t priority = 0;
+            if ((int64_t)(time - cache_time[vertex]) + 2 * (int64_t)live[vertex] <= (int64_t)cache_size) {
+                priority = time - cache_time[vertex];
+            }
+            if (priority > best_priority) {
+                best_priority = priority;
+                best = vertex;
+            }
+        }
+
+        if (best < 0) {
+            // Nothing left around the fanned vertices. Continuing at a vertex that was evicted starts a new
+            // cluster, one still in the cache keeps the current one going.
+            fanning = skip_dead_end();
+            if (clusters && fanning >= 0 && time - cache_time[fanning] > cache_size) {
+                clusters->push_back((uint32_t)output);
+            }
+        } else {
+            fanning = best;
+        }
+    }
+
+    assert(output == index_count);
+}
+
+void optimize_overdraw(uint32_t* destination,
+                       const uint32_t* indices,
+                       size_t index_count,
+                       const MeshVertex* vertices,
+                       size_t vertex_count,
+                       const std::vector<uint32_t>& clusters,
+                       uint32_t cache_size,
+                       float threshold) {
+    assert(index_count % 3 == 0);
+
+    if (index_count == 0) {
+        return;
+    }
+    assert(destination != indices);
+
+    float total_acmr = analyze_vertex_cache(indices, index_count, vertex_count, cache_size).acmr;
+
+    // Split the hard clusters wherever the piece so far, started with a cold cache, is already good enough.
+    std::vector<uint32_t> boundaries;
+    CacheSimulator cache(vertex_count, cache_size);
+    for (size_t c = 0; c < clusters.size(); c++) {
+        size_t begin = clusters[c];
+        size_t end = c + 1 < clusters.size() ? clusters[c + 1] : index_count;
+
+        boundaries.push_back((uint32_t)begin);
+        cache.flush();
+        size_t piece_begin = begin;
+        size_t misses = 0;
+        for (size_t i = begin; i < end; i += 3) {
+            misses += cache.access(indices[i]) + cache.access(indices[i + 1]) + cache.access(indices[i + 2]);
+
+            size_t triangles = (i + 3 - piece_begin) / 3;
+            if (i + 3 < end && (float)misses <= threshold * total_acmr * (float)triangles) {
+                boundaries.push_back((uint32_t)(i + 3));
+                cache.flush();
+                piece_begin = i + 3;
+                misses = 0;
+            }
+        }
+    }
+    if (boundaries.empty() || boundaries[0] != 0) {
+        boundaries.insert(boundaries.begin(), 0);
+    }
+
+    // Area-weighted centroid and normal of every piece, and of the whole mesh.
+    struct Piece {
+        uint32_t begin, end;
+        float centroid[3];
+        float normal[3];
+        float area;
+        float sort_key;
+    };
+    std::vector<Piece> pieces(boundaries.size());
+    float mesh_centroid[3] = {0.0f, 0.0f, 0.0f};
+    float mesh_area = 0.0f;
+
+    for (size_t p = 0; p < boundaries.size(); p++) {
+        Piece& piece = pieces[p];
+        piece = Piece{
+            .begin = boundaries[p],
+            .end = p + 1 < boundaries.size() ? boundaries[p + 1] : (uint32_t)index_count,
+            .centroid = {0.0f, 0.0f, 0.0f},
+            .normal = {0.0f, 0.0f, 0.0f},
+            .area = 0.0f,
+            .sort_key = 0.0f,
+        };
+
+        for (size_t i = piece.begin; i < piece.end; i += 3) {
+            const float* p0 = vertices[indices[i + 0]].position;
+            const float* p1 = vertices[indices[i + 1]].position;
+            const float* p2 = vertices[indices[i + 2]].position;
+
+            float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+            float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+            float n[3] = {
+                e1[1] * e2[2] - e1[2] * e2[1],
+                e1[2] * e2[0] - e1[0] * e2[2],
+                e1[0] * e2[1] - e1[1] * e2[0],
+            };
+            float area = 0.5f * sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+            for (int k = 0; k < 3; k++) {
+                piece.centroid[k] += area * (p0[k] + p1[k] + p2[k]) / 3.0f;
+                // The cross product is already weighted by area.
+                piece.normal[k] += n[k];
+            }
+            piece.area += area;
+        }
+
+        for (int k = 0; k < 3; k++) {
+            mesh_centroid[k] += piece.centroid[k];
+        }
+        mesh_area += piece.area;
+
+        if (piece.area > 0.0f) {
+            for (float& c : piece.centroid) {
+                c /= piece.area;
+            }
+        }
+        float length = sqrtf(piece.normal[0] * piece.normal[0] + piece.normal[1] * piece.normal[1] +
+                             piece.normal[2] * piece.normal[2]);
+        if (length > 0.0f) {
+            for (float& n : piece.normal) {
+                n /= length;
+            }
+        }
+    }
+    if (mesh_area > 0.0f) {
+        for (float& c : mesh_centroid) {
+            c /= mesh_area;
+        }
+    }
+
+    // Pieces on the outside, facing away from the center, first.
+    for (Piece& piece : pieces) {
+        piece.sort_key = (piece.centroid[0] - mesh_centroid[0]) * piece.normal[0] +
+                         (piece.centroid[1] - mesh_centroid[1]) * piece.normal[1] +
+                         (piece.centroid[2] - mesh_centroid[2]) * piece.normal[2];
+    }
+    std::stable_sort(
+        pieces.begin(), pieces.end(), [](const Piece& a, const Piece& b) { return a.sort_key > b.sort_key; });
+
+    size_t output = 0;
+    for (const Piece& piece : pieces) {
+        std::copy(indices + piece.begin, indices + piece.end, destination + output);
+        output += piece.end - piece.begin;
+    }
+    assert(output == index_count);
+}
+
+size_t optimize_vertex_fetch(MeshVertex* destination,
+                             uint32_t* indices,
+                             size_t index_count,
+                             const MeshVertex* vertices,
+                             size_t vertex_count) {
+    assert(vertex_count == 0 || destination != vertices);
+
+    std::vector<uint32_t> remap(vertex_count, UINT32_MAX);
+    uint32_t next = 0;
+    for (size_t i = 0; i < index_count; i++) {
+        uint32_t& target = remap[indices[i]];
+        if (target == UINT32_MAX) {
+            destination[next] = vertices[indices[i]];
+            target = next++;
+        }
+        indices[i] = target;
+    }
+    return next;
+}
+
+MeshOptimizeStats optimize_mesh(Mesh* mesh, const MeshOptimizeSettings& settings) {
+    if (mesh->lods.empty()) {
+        mesh_reset_lods(mesh);
+    }
+    if (mesh->indices.empty()) {
+        // Importers can produce empty meshes, there is nothing to reorder.
+        return MeshOptimizeStats{};
+    }
+
+    size_t vertex_count = mesh->vertices.size();
+    const MeshLod& base = mesh->lods[0];
+
+    MeshOptimizeStats stats = {};
+    stats.before = analyze_vertex_cache(
+        mesh->indices.data() + base.first_index, base.index_count, vertex_count, settings.cache_size);
+
+    // Each LOD is drawn on its own, optimize them separately.
+    std::vector<uint32_t> cache_ordered, clusters;
+    for (const MeshLod& lod : mesh->lods) {
+        uint32_t* lod_indices = mesh->indices.data() + lod.first_index;
+
+        cache_ordered.resize(lod.index_count);
+        optimize_vertex_cache(
+            cache_ordered.data(), lod_indices, lod.index_count, vertex_count, settings.cache_size, &clusters);
+        optimize_overdraw(lod_indices,
+                          cache_ordered.data(),
+                          lod.index_count,
+                          mesh->vertices.data(),
+                          vertex_count,
+                          clusters,
+                          settings.cache_size,
+                          settings.overdraw_threshold);
+    }
+
+    // LOD 0 comes first in the index buffer, so its vertices end up first and coarser LODs use a prefix-heavy
+    // subset of them.
+    std::vector<MeshVertex> vertices(vertex_count);
+    size_t used = optimize_vertex_fetch(
+        vertices.data(), mesh->indices.data(), mesh->indices.size(), mesh->vertices.data(), vertex_count);
+    vertices.resize(used);
+    mesh->vertices = std::move(vertices);
+
+    stats.after = analyze_vertex_cache(
+        mesh->indices.data() + base.first_index, base.index_count, mesh->vertices.size(), settings.cache_size);
+    return stats;
+}
+
+void optimize_meshes(std::vector<Mesh>& meshes,
+                     ThreadPool* pool,
+                     std::vector<MeshOptimizeStats>* stats,
+                     const MeshOptimizeSettings& settings) {
+    std::vector<MeshOptimizeStats> mesh_stats(meshes.size());
+
+    // Meshes are independent, one per task.
+    auto optimize_range = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            mesh_stats[i] = optimize_mesh(&meshes[i], settings);
+        }
+    };
+    if (pool) {
+        pool->parallel_for(meshes.size(), 1, optimize_range);
+    } else {
+        optimize_range(0, meshes.size());
+    }
+
+    if (stats) {
+        *stats = std::move(mesh_stats);
+    }
+}
+
+void import_meshes(WGPUDevice device,
+                   WGPUQueue queue,
+                   std::vector<Mesh>& meshes,
+                   ThreadPool* pool,
+                   std::vector<GpuMesh>* gpu_meshes,
+                   std::vector<MeshOptimizeStats>* stats,
+                   const MeshOptimizeSettings& settings) {
+    optimize_meshes(meshes, pool, stats, settings);
+
+    // Uploads stay on the calling thread, the queue is not shared.
+    gpu_meshes->clear();
+    gpu_meshes->reserve(meshes.size());
+    for (const Mesh& mesh : meshes) {
+        gpu_meshes->push_back(upload_mesh(device, queue, mesh));
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef MESH_OPTIMIZE_H
+#define MESH_OPTIMIZE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mesh.h"
+
+class ThreadPool;
+
+/// Post-transform vertex cache efficiency of an index buffer, simulated with a FIFO cache.
+struct VertexCacheStats {
+    /// Average cache miss ratio: vertex shader invocations per triangle. 0.5 is the ideal for a regular grid,
+    /// 3 means no reuse at all.
+    float acmr;
+    /// Average transformed vertex ratio: vertex shader invocations per referenced vertex, 1 is ideal.
+    float atvr;
+};
+
+struct MeshOptimizeSettings {
+    /// Size of the simulated FIFO cache. 16 is a conservative match for current GPUs.
+    uint32_t cache_size = 16;
+    /// How much worse than the cache-optimized order the ACMR may get when clusters are reordered for overdraw.
+    float overdraw_threshold = 1.05f;
+};
+
+struct MeshOptimizeStats {
+    /// LOD 0 as imported and after optimization.
+    VertexCacheStats before;
+    VertexCacheStats after;
+};
+
+VertexCacheStats analyze_vertex_cache(const uint32_t* indices,
+                                      size_t index_count,
+                                      size_t vertex_count,
+                                      uint32_t cache_size = 16);
+
+/// Reorders triangles for the post-transform cache with Tipsify (Sander, Nehab and Barczak 2007): triangles are
+/// emitted in fans around a vertex, moving to the neighbour that is still in the cache and will stay there.
+///
+/// If `clusters` is not null, it receives the index offsets at which the walk had to jump to a vertex outside
+/// the cache, starting with 0. Triangles between two offsets form a cluster that can be moved as a whole.
+void optimize_vertex_cache(uint32_t* destination,
+                           const uint32_t* indices,
+                           size_t index_count,
+                           size_t vertex_count,
+                           uint32_t cache_size = 16,
+                           std::vector<uint32_t>* clusters = nullptr);
+
+/// Reorders the clusters of a cache-optimized index buffer so that triangles facing away from the mesh center,
+/// which tend to occlude the rest, are drawn first.
+///
+/// `clusters` comes from `optimize_vertex_cache`. Clusters are split further, starting each piece with a cold
+/// cache, as long as every piece stays within `threshold` times the ACMR of the whole buffer.
+void optimize_overdraw(uint32_t* destination,
+                       const uint32_t* indices,
+                       size_t index_count,
+                       const MeshVertex* vertices,
+                       size_t vertex_count,
+                       const std::vector<uint32_t>& clusters,
+                       uint32_t cache_size = 16,
+                       float threshold = 1.05f);
+
+/// Reorders vertices in the order the indices first use them and rewrites `indices` to match, so that vertex
+/// fetches walk memory forwards. Unused vertices are dropped. Returns the new vertex count.
+size_t optimize_vertex_fetch(MeshVertex* destination,
+                             uint32_t* indices,
+                             size_t index_count,
+                             const MeshVertex* vertices,
+                             size_t vertex_count);
+
+/// Runs the cache, overdraw and fetch optimizations on every LOD of `mesh`.
+MeshOptimizeStats optimize_mesh(Mesh* mesh, const MeshOptimizeSettings& settings = {});
+
+/// Runs `optimize_mesh` on every mesh, in parallel over `pool` (may be null). `stats`, if not null, receives one
+/// entry per mesh.
+void optimize_meshes(std::vector<Mesh>& meshes,
+                     ThreadPool* pool,
+                     std::vector<MeshOptimizeStats>* stats = nullptr,
+                     const MeshOptimizeSettings& settings = {});
+
+/// Optimizes `meshes` with `optimize_meshes`, then uploads each to its own vertex and index
+/// buffer with `create_buffer`. `stats`, if not null, receives one entry per mesh.
+void import_meshes(WGPUDevice device,
+                   WGPUQueue queue,
+                   std::vector<Mesh>& meshes,
+                   ThreadPool* pool,
+                   std::vector<GpuMesh>* gpu_meshes,
+                   std::vector<MeshOptimizeStats>* stats = nullptr,
+                   const MeshOptimizeSettings& settings = {});
+
+#endif // MESH_OPTIMIZE_H
@@ -1,9 +1,17 @@
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
+#include <vector>
 
+#include "../async_logger.h"
 #include "../common.h"
+#include "../config.h"
+#include "../draw_queue.h"
+#include "../frame_pacer.h"
+#include "../perf_overlay.h"
 
 #ifdef EMSCRIPTEN
     #include <webgpu/webgpu.h>
@@ -42,6 +50,9 @@ struct RenderContext {
     WGPUAdapter adapter;
     WGPUDevice device;
     WGPUSurfaceConfiguration config;
+    FramePacer pacer;
+    PerfOverlay overlay;
+    AsyncLogger* logger;
 };
 
 static void handle_request_adapter(WGPURequestAdapterStatus status,
@@ -52,7 +63,8 @@ static void handle_request_adapter(WGPURequestAdapterStatus status,
         auto context = (RenderContext*)userdata;
         context->adapter = adapter;
     } else {
-        printf(LOG_PREFIX " request_adapter status=%#.8x message=%s\n", status, message);
+        auto context = (RenderContext*)userdata;
+        context->logger->log(LogLevel_Error, LOG_PREFIX " request_adapter status=%#.8x message=%s", status, message);
     }
 }
 
@@ -64,14 +76,36 @@ static void handle_request_device(WGPURequestDeviceStatus status,
         auto context = (RenderContext*)userdata;
         context->device = device;
     } else {
-        printf(LOG_PREFIX " request_device status=%#.8x message=%s\n", status, message);
+        auto context = (RenderContext*)userdata;
+        context->logger->log(LogLevel_Error, LOG_PREFIX " request_device status=%#.8x message=%s", status, message);
     }
 }
 
+static void handle_device_error(WGPUErrorType type, char const* message, void* userdata) {
+    auto context = (RenderContext*)userdata;
+    context->logger->log(LogLevel_Error, LOG_PREFIX " device error type=%#.8x message=%s", type, message);
+}
+
+static void handle_wgpu_log(WGPULogLevel level, char const* message, void* userdata) {
+    // Called from whichever thread wgpu logs on, must not block. wgpu already filtered by its own level.
+    auto logger = (AsyncLogger*)userdata;
+    logger->log_unfiltered(to_log_level(level), LOG_PREFIX " %s", message);
+}
+
 static void handle_glfw_key(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    auto context = (RenderContext*)glfwGetWindowUserPointer(window);
+    if (!context) {
+        return;
+    }
+
+    context->pacer.mark_dirty(Damage_Input);
+
+    if (key == GLFW_KEY_F1 && action == GLFW_PRESS) {
+        context->overlay.visible = !context->overlay.visible;
+    }
+
     if (key == GLFW_KEY_R && (action == GLFW_PRESS || action == GLFW_REPEAT)) {
-        auto context = (RenderContext*)glfwGetWindowUserPointer(window);
-        if (!context || !context->instance) {
+        if (!context->instance) {
             return;
         }
 
@@ -97,25 +131,90 @@ static void handle_glfw_framebuffer_size(GLFWwindow* window, int width, int heig
     context->config.height = height;
 
     wgpuSurfaceConfigure(context->surface, &context->config);
+    context->pacer.mark_dirty(Damage_Resize);
+}
+
+static void handle_glfw_cursor_pos(GLFWwindow* window, double, double) {
+    if (auto context = (RenderContext*)glfwGetWindowUserPointer(window)) {
+        context->pacer.mark_dirty(Damage_Input);
+    }
+}
+
+static void handle_glfw_mouse_button(GLFWwindow* window, int, int, int) {
+    if (auto context = (RenderContext*)glfwGetWindowUserPointer(window)) {
+        context->pacer.mark_dirty(Damage_Input);
+    }
+}
+
+static void handle_glfw_scroll(GLFWwindow* window, double x_offset, double y_offset) {
+    if (auto context = (RenderContext*)glfwGetWindowUserPointer(window)) {
+        context->pacer.mark_dirty(Damage_Input);
+        nk_wgpu_scroll_callback(&context->overlay.nk, x_offset, y_offset);
+    }
+}
+
+static void handle_glfw_char(GLFWwindow* window, unsigned int codepoint) {
+    if (auto context = (RenderContext*)glfwGetWindowUserPointer(window)) {
+        context->pacer.mark_dirty(Damage_Input);
+        nk_wgpu_char_callback(&context->overlay.nk, codepoint);
+    }
+}
+
+static void handle_glfw_window_refresh(GLFWwindow* window) {
+    // The window system lost the window contents, e.g. after being uncovered.
+    if (auto context = (RenderContext*)glfwGetWindowUserPointer(window)) {
+        context->pacer.mark_dirty(Damage_Expose);
+    }
 }
 
 int main(int argc, char* argv[]) {
+    AppConfig app_config;
+    if (!parse_config(&app_config, argc, argv)) {
+        return 1;
+    }
+
+    AsyncLogger logger;
+    logger.set_level(app_config.log_level);
+    wgpuSetLogCallback(handle_wgpu_log, &logger);
+    wgpuSetLogLevel(app_config.wgpu_log_level);
+
 #if defined(WGPU_TARGET_LINUX_WAYLAND)
     glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_WAYLAND);
 #endif
     assert(glfwInit());
 
     RenderContext context = {};
-    context.instance = wgpuCreateInstance(nullptr);
+    context.logger = &logger;
+    // Benchmarks need every frame rendered.
+    context.pacer.on_demand = app_config.on_demand && app_config.bench_frames == 0;
+
+    WGPUInstanceExtras instance_extras = make_instance_extras(app_config);
+    WGPUInstanceDescriptor instance_descriptor = {
+        .nextInChain = (const WGPUChainedStruct*)&instance_extras,
+    };
+
+    context.instance = wgpuCreateInstance(&instance_descriptor);
     assert(context.instance);
 
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
     GLFWwindow* window = glfwCreateWindow(640, 480, "wgpu-native + glfw", nullptr, nullptr);
     assert(window);
 
+    if (GLFWmonitor* monitor = glfwGetPrimaryMonitor()) {
+        const GLFWvidmode* mode = glfwGetVideoMode(monitor);
+        if (mode && mode->refreshRate > 0) {
+            context.pacer.refresh_interval = 1.0 / mode->refreshRate;
+        }
+    }
+
     glfwSetWindowUserPointer(window, &context);
     glfwSetKeyCallback(window, handle_glfw_key);
     glfwSetFramebufferSizeCallback(window, handle_glfw_framebuffer_size);
+    glfwSetCursorPosCallback(window, handle_glfw_cursor_pos);
+    glfwSetMouseButtonCallback(window, handle_glfw_mouse_button);
+    glfwSetScrollCallback(window, handle_glfw_scroll);
+    glfwSetCharCallback(window, handle_glfw_char);
+    glfwSetWindowRefreshCallback(window, handle_glfw_window_refresh);
 
 #if defined(WGPU_TARGET_MACOS)
     {
@@ -231,11 +330,16 @@ int main(int argc, char* argv[]) {
     };
 
     wgpuInstanceRequestAdapter(context.instance, &request_adapter_options, handle_request_adapter, &context);
+    // The failure was logged asynchronously, make sure it is out before the assert fires.
+    logger.flush();
     assert(context.adapter);
 
     wgpuAdapterRequestDevice(context.adapter, nullptr, handle_request_device, &context);
+    logger.flush();
     assert(context.device);
 
+    wgpuDeviceSetUncapturedErrorCallback(context.device, handle_device_error, &context);
+
     WGPUQueue queue = wgpuDeviceGetQueue(context.device);
     assert(queue);
 
@@ -316,8 +420,47 @@ int main(int argc, char* argv[]) {
 
     wgpuSurfaceConfigure(context.surface, &context.config);
 
+    DrawQueue draw_queue;
+
+    perf_overlay_init(&context.overlay, window, context.instance, context.device, queue, context.config.format);
+    context.overlay.visible = app_config.overlay;
+
+    // CPU cost of every frame, only kept with --bench-frames.
+    std::vector<double> frame_costs;
+    frame_costs.reserve(app_config.bench_frames);
+
+    // Set once the loop slept, so that the overlay does not count the idle time as frame time.
+    bool idled = false;
+
     while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+        if (perf_overlay_needs_refresh(&context.overlay)) {
+            context.pacer.mark_dirty(Damage_Data);
+        }
+
+        if (context.pacer.has_damage()) {
+            glfwPollEvents();
+        } else {
+            // Nothing to draw, sleep until an event arrives or the timeout elapses.
+            glfwWaitEventsTimeout(context.pacer.idle_timeout);
+            idled = true;
+        }
+
+        FrameReport report;
+        if (context.pacer.poll_report(&report)) {
+            logger.log(LogLevel_Info,
+                       LOG_PREFIX " frames rendered=%llu skipped=%llu cpu=%.1f%%",
+                       (unsigned long long)report.frames_rendered,
+                       (unsigned long long)report.frames_skipped,
+                       report.cpu_percent);
+        }
+
+        if (!context.pacer.begin_frame()) {
+            continue;
+        }
+
+        perf_overlay_begin_frame(&context.overlay, idled);
+        idled = false;
+        auto acquire_start = std::chrono::steady_clock::now();
 
         WGPUSurfaceTexture surface_texture;
         wgpuSurfaceGetCurrentTexture(context.surface, &surface_texture);
@@ -341,17 +484,24 @@ int main(int argc, char* argv[]) {
                     context.config.height = height;
                     wgpuSurfaceConfigure(context.surface, &context.config);
                 }
+                // The frame was not drawn, try again on the next iteration.
+                context.pacer.mark_dirty(Damage_Resize);
                 continue;
             }
             case WGPUSurfaceGetCurrentTextureStatus_OutOfMemory:
             case WGPUSurfaceGetCurrentTextureStatus_DeviceLost:
             case WGPUSurfaceGetCurrentTextureStatus_Force32:
                 // Fatal error
-                printf(LOG_PREFIX " get_current_texture status=%#.8x\n", surface_texture.status);
+                logger.log(LogLevel_Error, LOG_PREFIX " get_current_texture status=%#.8x", surface_texture.status);
+                logger.flush();
                 abort();
         }
         assert(surface_texture.texture);
 
+        auto scene_start = std::chrono::steady_clock::now();
+        context.overlay.cpu_acquire_ms =
+            std::chrono::duration<double, std::milli>(scene_start - acquire_start).count();
+
         WGPUTextureView surface_view = wgpuTextureCreateView(surface_texture.texture, nullptr);
         assert(surface_view);
 
@@ -388,8 +538,21 @@ int main(int argc, char* argv[]) {
             wgpuCommandEncoderBeginRenderPass(command_encoder, &render_pass_descriptor);
         assert(render_pass_encoder);
 
-        wgpuRenderPassEncoderSetPipeline(render_pass_encoder, render_pipeline);
-        wgpuRenderPassEncoderDraw(render_pass_encoder, 3, 1, 0, 0);
+        draw_queue.reset();
+        draw_queue.submit(DrawItem{
+            .pipeline = render_pipeline,
+            .count = 3,
+            .instance_count = 1,
+        });
+        draw_queue.sort();
+        draw_queue.encode(render_pass_encoder, 0);
+
+        auto scene_end = std::chrono::steady_clock::now();
+        context.overlay.cpu_scene_ms = std::chrono::duration<double, std::milli>(scene_end - scene_start).count();
+        context.overlay.scene_draws = draw_queue.stats().draws;
+        context.overlay.scene_state_changes_saved = draw_queue.stats().state_changes_saved;
+
+        perf_overlay_render(&context.overlay, render_pass_encoder);
 
         wgpuRenderPassEncoderEnd(render_pass_encoder);
 
@@ -402,8 +565,23 @@ int main(int argc, char* argv[]) {
 
         std::array<WGPUCommandBuffer, 1> command_buffers = {command_buffer};
 
+        auto submit_start = std::chrono::steady_clock::now();
         wgpuQueueSubmit(queue, command_buffers.size(), command_buffers.data());
+        auto submit_end = std::chrono::steady_clock::now();
+        context.overlay.cpu_submit_ms = std::chrono::duration<double, std::milli>(submit_end - submit_start).count();
+        if (app_config.bench_frames) {
+            // Encoding, validation and submission, without waiting for the swap chain.
+            frame_costs.push_back(std::chrono::duration<double, std::milli>(submit_end - scene_start).count());
+            if (frame_costs.size() >= app_config.bench_frames) {
+                glfwSetWindowShouldClose(window, GLFW_TRUE);
+            }
+        }
+        perf_overlay_on_submit(&context.overlay);
+
+        auto present_start = std::chrono::steady_clock::now();
         wgpuSurfacePresent(context.surface);
+        context.overlay.cpu_present_ms =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - present_start).count();
 
         wgpuCommandBufferRelease(command_buffer);
         wgpuRenderPassEncoderRelease(render_pass_encoder);
@@ -412,6 +590,26 @@ int main(int argc, char* argv[]) {
         wgpuTextureRelease(surface_texture.texture);
     }
 
+    logger.log(LogLevel_Info,
+               LOG_PREFIX " total frames rendered=%llu skipped=%llu",
+               (unsigned long long)context.pacer.total_rendered(),
+               (unsigned long long)context.pacer.total_skipped());
+
+    if (!frame_costs.empty()) {
+        std::sort(frame_costs.begin(), frame_costs.end());
+        double sum = 0;
+        for (double cost : frame_costs) {
+            sum += cost;
+        }
+        printf("validation=%s frames=%zu mean_ms=%.4f median_ms=%.4f p95_ms=%.4f\n",
+               validation_name(app_config.validation),
+               frame_costs.size(),
+               sum / (double)frame_costs.size(),
+               frame_costs[frame_costs.size() / 2],
+               frame_costs[frame_costs.size() * 95 / 100]);
+    }
+
+    perf_overlay_shutdown(&context.overlay);
     wgpuRenderPipelineRelease(render_pipeline);
     wgpuPipelineLayoutRelease(pipeline_layout);
     wgpuShaderModuleRelease(shader_module);
@@ -424,5 +622,10 @@ int main(int argc, char* argv[]) {
     wgpuInstanceRelease(context.instance);
     glfwTerminate();
 
+    wgpuSetLogCallback(nullptr, nullptr);
+    if (logger.dropped()) {
+        fprintf(stderr, LOG_PREFIX " %llu log messages dropped\n", (unsigned long long)logger.dropped());
+    }
+
     return 0;
 }
@@ -0,0 +1,568 @@
+// Nuklear is C code, some of its flag arithmetic is deprecated in C++20.
+#if defined(__GNUC__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wdeprecated-enum-enum-conversion"
+#endif
+#define NK_IMPLEMENTATION
+#include "nuklear_wgpu.h"
+#if defined(__GNUC__)
+    #pragma GCC diagnostic pop
+#endif
+
+#include <GLFW/glfw3.h>
+
+#include <array>
+#include <cassert>
+#include <cstring>
+
+static const char* nk_wgpu_shader = R"(
+struct Uniforms {
+    projection : mat4x4<f32>,
+};
+@group(0) @binding(0) var<uniform> uniforms : Uniforms;
+@group(0) @binding(1) var ui_sampler : sampler;
+@group(0) @binding(2) var ui_texture : texture_2d<f32>;
+
+struct VertexIn {
+    @location(0) position : vec2<f32>,
+    @location(1) uv : vec2<f32>,
+    @location(2) color : vec4<f32>,
+};
+
+struct VertexOut {
+    @builtin(position) position : vec4<f32>,
+    @location(0) uv : vec2<f32>,
+    @location(1) color : vec4<f32>,
+};
+
+@vertex
+fn vs_main(input : VertexIn) -> VertexOut {
+    var output : VertexOut;
+    output.position = uniforms.projection * vec4<f32>(input.position, 0.0, 1.0);
+    output.uv = input.uv;
+    output.color = input.color;
+    return output;
+}
+
+@fragment
+fn fs_main(input : VertexOut) -> @location(0) vec4<f32> {
+    return input.color * textureSample(ui_texture, ui_sampler, input.uv);
+}
+)";
+
+static size_t grow_capacity(size_t capacity, size_t required) {
+    if (capacity == 0) {
+        capacity = 4096;
+    }
+    while (capacity < required) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+static void ensure_buffer(NkWgpu* nk, WGPUBuffer* buffer, size_t* capacity, size_t required, WGPUBufferUsage usage) {
+    if (*buffer && *capacity >= required) {
+        return;
+    }
+
+    if (*buffer) {
+        wgpuBufferRelease(*buffer);
+    }
+
+    *capacity = grow_capacity(*capacity, required);
+    *buffer = create_buffer(nk->device, nk->queue, *capacity, usage);
+    assert(*buffer);
+}
+
+static WGPUBindGroup get_texture_bind_group(NkWgpu* nk, WGPUTextureView view) {
+    std::array<WGPUBindGroupEntry, 3> entries = {
+        WGPUBindGroupEntry{
+            .binding = 0,
+            .buffer = nk->uniform_buffer,
+            .size = sizeof(float) * 16,
+        },
+        WGPUBindGroupEntry{
+            .binding = 1,
+            .sampler = nk->sampler,
+        },
+        WGPUBindGroupEntry{
+            .binding = 2,
+            .textureView = view,
+        },
+    };
+
+    WGPUBindGroupDescriptor bind_group_descriptor = {
+        .label = "nk_bind_group",
+        .layout = nk->bind_group_layout,
+        .entryCount = entries.size(),
+        .entries = entries.data(),
+    };
+
+    return nk->bind_groups.get(nk->device, bind_group_descriptor);
+}
+
+static void create_pipeline(NkWgpu* nk, WGPUTextureFormat format) {
+    std::array<WGPUBindGroupLayoutEntry, 3> layout_entries = {
+        WGPUBindGroupLayoutEntry{
+            .binding = 0,
+            .visibility = WGPUShaderStage_Vertex,
+            .buffer =
+                WGPUBufferBindingLayout{
+                    .type = WGPUBufferBindingType_Uniform,
+                    .minBindingSize = sizeof(float) * 16,
+                },
+        },
+        WGPUBindGroupLayoutEntry{
+            .binding = 1,
+            .visibility = WGPUShaderStage_Fragment,
+            .sampler =
+                WGPUSamplerBindingLayout{
+                    .type = WGPUSamplerBindingType_Filtering,
+                },
+        },
+        WGPUBindGroupLayoutEntry{
+            .binding = 2,
+            .visibility = WGPUShaderStage_Fragment,
+            .texture =
+                WGPUTextureBindingLayout{
+                    .sampleType = WGPUTextureSampleType_Float,
+                    .viewDimension = WGPUTextureViewDimension_2D,
+                },
+        },
+    };
+
+    WGPUBindGroupLayoutDescriptor bind_group_layout_descriptor = {
+        .label = "nk_bind_group_layout",
+        .entryCount = layout_entries.size(),
+        .entries = layout_entries.data(),
+    };
+    nk->bind_group_layout = wgpuDeviceCreateBindGroupLayout(nk->device, &bind_group_layout_descriptor);
+    assert(nk->bind_group_layout);
+
+    WGPUPipelineLayoutDescriptor pipeline_layout_descriptor = {
+        .label = "nk_pipeline_layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &nk->bind_group_layout,
+    };
+    nk->pipeline_layout = wgpuDeviceCreatePipelineLayout(nk->device, &pipeline_layout_descriptor);
+    assert(nk->pipeline_layout);
+
+    WGPUShaderModule shader_module = create_shader(nk->device, nk_wgpu_shader, "nk_shader");
+    assert(shader_module);
+
+    std::array<WGPUVertexAttribute, 3> vertex_attributes = {
+        WGPUVertexAttribute{
+            .format = WGPUVertexFormat_Float32x2,
+            .offset = offsetof(NkWgpuVertex, position),
+            .shaderLocation = 0,
+        },
+        WGPUVertexAttribute{
+            .format = WGPUVertexFormat_Float32x2,
+            .offset = offsetof(NkWgpuVertex, uv),
+            .shaderLocation = 1,
+        },
+        WGPUVertexAttribute{
+            .format = WGPUVertexFormat_Unorm8x4,
+            .offset = offsetof(NkWgpuVertex, col),
+            .shaderLocation = 2,
+        },
+    };
+
+    WGPUVertexBufferLayout vertex_buffer_layout = {
+        .arrayStride = sizeof(NkWgpuVertex),
+        .stepMode = WGPUVertexStepMode_Vertex,
+        .attributeCount = vertex_attributes.size(),
+        .attributes = vertex_attributes.data(),
+    };
+
+    WGPUBlendState blend_state = {
+        .color =
+            WGPUBlendComponent{
+                .operation = WGPUBlendOperation_Add,
+                .srcFactor = WGPUBlendFactor_SrcAlpha,
+                .dstFactor = WGPUBlendFactor_OneMinusSrcAlpha,
+            },
+        .alpha =
+            WGPUBlendComponent{
+                .operation = WGPUBlendOperation_Add,
+                .srcFactor = WGPUBlendFactor_One,
+                .dstFactor = WGPUBlendFactor_OneMinusSrcAlpha,
+            },
+    };
+
+    std::array<WGPUColorTargetState, 1> color_target_states = {
+        WGPUColorTargetState{
+            .format = format,
+            .blend = &blend_state,
+            .writeMask = WGPUColorWriteMask_All,
+        },
+    };
+
+    WGPUFragmentState fragment_state = {
+        .module = shader_module,
+        .entryPoint = "fs_main",
+        .targetCount = color_target_states.size(),
+        .targets = color_target_states.data(),
+    };
+
+    WGPURenderPipelineDescriptor render_pipeline_descriptor = {
+        .label = "nk_render_pipeline",
+        .layout = nk->pipeline_layout,
+        .vertex =
+            WGPUVertexState{
+                .module = shader_module,
+                .entryPoint = "vs_main",
+                .bufferCount = 1,
+                .buffers = &vertex_buffer_layout,
+            },
+        .primitive =
+            WGPUPrimitiveState{
+                .topology = WGPUPrimitiveTopology_TriangleList,
+                .cullMode = WGPUCullMode_None,
+            },
+        .multisample =
+            WGPUMultisampleState{
+                .count = 1,
+                .mask = 0xFFFFFFFF,
+            },
+        .fragment = &fragment_state,
+    };
+
+    nk->pipeline = wgpuDeviceCreateRenderPipeline(nk->device, &render_pipeline_descriptor);
+    assert(nk->pipeline);
+
+    wgpuShaderModuleRelease(shader_module);
+
+    WGPUSamplerDescriptor sampler_descriptor = {
+        .label = "nk_sampler",
+        .addressModeU = WGPUAddressMode_ClampToEdge,
+        .addressModeV = WGPUAddressMode_ClampToEdge,
+        .addressModeW = WGPUAddressMode_ClampToEdge,
+        .magFilter = WGPUFilterMode_Linear,
+        .minFilter = WGPUFilterMode_Linear,
+        .mipmapFilter = WGPUMipmapFilterMode_Nearest,
+        .lodMinClamp = 0.0f,
+        .lodMaxClamp = 32.0f,
+        .maxAnisotropy = 1,
+    };
+    nk->sampler = wgpuDeviceCreateSampler(nk->device, &sampler_descriptor);
+    assert(nk->sampler);
+
+    nk->uniform_buffer =
+        create_buffer(nk->device, nk->queue, sizeof(float) * 16, WGPUBufferUsage(WGPUBufferUsage_Uniform));
+    assert(nk->uniform_buffer);
+}
+
+static void upload_font_atlas(NkWgpu* nk, const void* image, int width, int height) {
+    WGPUExtent3D size = {
+        .width = (uint32_t)width,
+        .height = (uint32_t)height,
+        .depthOrArrayLayers = 1,
+    };
+
+    WGPUTextureDescriptor texture_descriptor = {
+        .label = "nk_font_texture",
+        .usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst,
+        .dimension = WGPUTextureDimension_2D,
+        .size = size,
+        .format = WGPUTextureFormat_RGBA8Unorm,
+        .mipLevelCount = 1,
+        .sampleCount = 1,
+    };
+    nk->font_texture = wgpuDeviceCreateTexture(nk->device, &texture_descriptor);
+    assert(nk->font_texture);
+
+    WGPUImageCopyTexture destination = {
+        .texture = nk->font_texture,
+        .aspect = WGPUTextureAspect_All,
+    };
+
+    WGPUTextureDataLayout data_layout = {
+        .bytesPerRow = (uint32_t)width * 4,
+        .rowsPerImage = (uint32_t)height,
+    };
+
+    wgpuQueueWriteTexture(nk->queue, &destination, image, (size_t)width * height * 4, &data_layout, &size);
+
+    nk->font_view = wgpuTextureCreateView(nk->font_texture, nullptr);
+    assert(nk->font_view);
+}
+
+static void update_projection(NkWgpu* nk) {
+    if (nk->projection_width == nk->width && nk->projection_height == nk->height) {
+        return;
+    }
+
+    // Orthographic projection from window coordinates (origin top-left) to clip space.
+    float w = (float)nk->width;
+    float h = (float)nk->height;
+    float projection[16] = {
+        2.0f / w, 0.0f, 0.0f, 0.0f, // Column 0
+        0.0f, -2.0f / h, 0.0f, 0.0f, // Column 1
+        0.0f, 0.0f, 1.0f, 0.0f, // Column 2
+        -1.0f, 1.0f, 0.0f, 1.0f, // Column 3
+    };
+    write_buffer(nk->queue, nk->uniform_buffer, 0, projection, sizeof(projection));
+
+    nk->projection_width = nk->width;
+    nk->projection_height = nk->height;
+}
+
+static void nk_wgpu_clipboard_paste(nk_handle usr, nk_text_edit* edit) {
+    auto nk = (NkWgpu*)usr.ptr;
+    const char* text = glfwGetClipboardString(nk->window);
+    if (text) {
+        nk_textedit_paste(edit, text, nk_strlen(text));
+    }
+}
+
+static void nk_wgpu_clipboard_copy(nk_handle usr, const char* text, int len) {
+    auto nk = (NkWgpu*)usr.ptr;
+    if (!len) {
+        return;
+    }
+
+    char* str = (char*)malloc((size_t)len + 1);
+    if (!str) {
+        return;
+    }
+    memcpy(str, text, (size_t)len);
+    str[len] = '\0';
+    glfwSetClipboardString(nk->window, str);
+    free(str);
+}
+
+nk_context* nk_wgpu_init(NkWgpu* nk, GLFWwindow* window, WGPUDevice device, WGPUQueue queue, WGPUTextureFormat format) {
+    *nk = {};
+    nk->window = window;
+    nk->device = device;
+    nk->queue = queue;
+
+    nk_init_default(&nk->ctx, nullptr);
+    nk->ctx.clip.copy = nk_wgpu_clipboard_copy;
+    nk->ctx.clip.paste = nk_wgpu_clipboard_paste;
+    nk->ctx.clip.userdata = nk_handle_ptr(nk);
+
+    nk_buffer_init_default(&nk->cmds);
+    nk_buffer_init_default(&nk->vertices);
+    nk_buffer_init_default(&nk->elements);
+
+    create_pipeline(nk, format);
+
+    nk_font_atlas_init_default(&nk->atlas);
+    nk_font_atlas_begin(&nk->atlas);
+    nk_font* font = nk_font_atlas_add_default(&nk->atlas, 13.0f, nullptr);
+
+    int width, height;
+    const void* image = nk_font_atlas_bake(&nk->atlas, &width, &height, NK_FONT_ATLAS_RGBA32);
+    upload_font_atlas(nk, image, width, height);
+    nk_font_atlas_end(&nk->atlas, nk_handle_ptr(nk->font_view), &nk->null_texture);
+
+    nk_style_set_font(&nk->ctx, &font->handle);
+
+    return &nk->ctx;
+}
+
+void nk_wgpu_new_frame(NkWgpu* nk) {
+    nk_context* ctx = &nk->ctx;
+    GLFWwindow* win = nk->window;
+
+    glfwGetWindowSize(win, &nk->width, &nk->height);
+    glfwGetFramebufferSize(win, &nk->display_width, &nk->display_height);
+
+    nk_input_begin(ctx);
+    for (int i = 0; i < nk->text_len; i++) {
+        nk_input_unicode(ctx, nk->text[i]);
+    }
+
+    bool control = glfwGetKey(win, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS ||
+                   glfwGetKey(win, GLFW_KEY_RIGHT_CONTROL) == GLFW_PRESS;
+
+    nk_input_key(ctx, NK_KEY_DEL, glfwGetKey(win, GLFW_KEY_DELETE) == GLFW_PRESS);
+    nk_input_key(ctx, NK_KEY_ENTER, glfwGetKey(win, GLFW_KEY_ENTER) == GLFW_PRESS);
+    nk_input_key(ctx, NK_KEY_TAB, glfwGetKey(win, GLFW_KEY_TAB) == GLFW_PRESS);
+    nk_input_key(ctx, NK_KEY_BACKSPACE, glfwGetKey(win, GLFW_KEY_BACKSPACE) == GLFW_PRESS);
+    nk_input_key(ctx, NK_KEY_UP, glfwGetKey(win, GLFW_KEY_UP) == GLFW_PRESS);
+    nk_input_key(ctx, NK_KEY_DOWN, glfwGetKey(win, GLFW_KEY_DOWN) == GLFW_PRESS);
+    nk_input_key(ctx, NK_KEY_LEFT, !control && glfwGetKey(win, GLFW_KEY_LEFT) == GLFW_PRESS);
+    nk_input_key(ctx, NK_KEY_RIGHT, !control && glfwGetKey(win, GLFW_KEY_RIGHT) == GLFW_PRESS);
+    nk_input_key(ctx, NK_KEY_SHIFT,
+                 glfwGetKey(win, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS ||
+                     glfwGetKey(win, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS);
+    nk_input_key(ctx, NK_KEY_COPY, control && glfwGetKey(win, GLFW_KEY_C) == GLFW_PRESS);
+    nk_input_key(ctx, NK_KEY_PASTE, control && glfwGetKey(win, GLFW_KEY_V) == GLFW_PRESS);
+    nk_input_key(ctx, NK_KEY_CUT, control && glfwGetKey(win, GLFW_KEY_X) == GLFW_PRESS);
+
+    double x, y;
+    glfwGetCursorPos(win, &x, &y);
+    nk_input_motion(ctx, (int)x, (int)y);
+    nk_input_button(ctx, NK_BUTTON_LEFT, (int)x, (int)y, glfwGetMouseButton(win, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS);
+    nk_input_button(
+        ctx, NK_BUTTON_MIDDLE, (int)x, (int)y, glfwGetMouseButton(win, GLFW_MOUSE_BUTTON_MIDDLE) == GLFW_PRESS);
+    nk_input_button(
+        ctx, NK_BUTTON_RIGHT, (int)x, (int)y, glfwGetMouseButton(win, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS);
+    nk_input_scroll(ctx, nk->scroll);
+    nk_input_end(ctx);
+
+    nk->text_len = 0;
+    nk->scroll = nk_vec2(0, 0);
+}
+
+void nk_wgpu_render(NkWgpu* nk, WGPURenderPassEncoder render_pass, nk_anti_aliasing aa) {
+    nk->stats = {};
+
+    if (nk->width <= 0 || nk->height <= 0 || nk->display_width <= 0 || nk->display_height <= 0) {
+        nk_clear(&nk->ctx);
+        return;
+    }
+
+    static const nk_draw_vertex_layout_element vertex_layout[] = {
+        {NK_VERTEX_POSITION, NK_FORMAT_FLOAT, NK_OFFSETOF(NkWgpuVertex, position)},
+        {NK_VERTEX_TEXCOORD, NK_FORMAT_FLOAT, NK_OFFSETOF(NkWgpuVertex, uv)},
+        {NK_VERTEX_COLOR, NK_FORMAT_R8G8B8A8, NK_OFFSETOF(NkWgpuVertex, col)},
+        {NK_VERTEX_LAYOUT_END},
+    };
+
+    nk_convert_config config = {};
+    config.vertex_layout = vertex_layout;
+    config.vertex_size = sizeof(NkWgpuVertex);
+    config.vertex_alignment = NK_ALIGNOF(NkWgpuVertex);
+    config.null = nk->null_texture;
+    config.circle_segment_count = 22;
+    config.curve_segment_count = 22;
+    config.arc_segment_count = 22;
+    config.global_alpha = 1.0f;
+    config.shape_AA = aa;
+    config.line_AA = aa;
+
+    nk_buffer_clear(&nk->cmds);
+    nk_buffer_clear(&nk->vertices);
+    nk_buffer_clear(&nk->elements);
+    nk_convert(&nk->ctx, &nk->cmds, &nk->vertices, &nk->elements, &config);
+
+    size_t vertex_size = nk_buffer_total(&nk->vertices);
+    size_t index_size = nk_buffer_total(&nk->elements);
+    if (vertex_size == 0 || index_size == 0) {
+        nk_clear(&nk->ctx);
+        return;
+    }
+
+    ensure_buffer(nk, &nk->vertex_buffer, &nk->vertex_capacity, vertex_size, WGPUBufferUsage_Vertex);
+    ensure_buffer(nk, &nk->index_buffer, &nk->index_capacity, index_size, WGPUBufferUsage_Index);
+
+    // One upload per buffer for the whole UI.
+    write_buffer(nk->queue, nk->vertex_buffer, 0, nk_buffer_memory_const(&nk->vertices), vertex_size);
+    write_buffer(nk->queue, nk->index_buffer, 0, nk_buffer_memory_const(&nk->elements), index_size);
+    update_projection(nk);
+
+    nk->stats.vertices = (uint32_t)(vertex_size / sizeof(NkWgpuVertex));
+    nk->stats.indices = (uint32_t)(index_size / sizeof(nk_draw_index));
+    nk->stats.upload_bytes = vertex_size + index_size;
+
+    wgpuRenderPassEncoderSetViewport(
+        render_pass, 0, 0, (float)nk->display_width, (float)nk->display_height, 0.0f, 1.0f);
+    wgpuRenderPassEncoderSetPipeline(render_pass, nk->pipeline);
+    wgpuRenderPassEncoderSetVertexBuffer(render_pass, 0, nk->vertex_buffer, 0, vertex_size);
+    wgpuRenderPassEncoderSetIndexBuffer(render_pass, nk->index_buffer, WGPUIndexFormat_Uint32, 0, index_size);
+
+    float scale_x = (float)nk->display_width / (float)nk->width;
+    float scale_y = (float)nk->display_height / (float)nk->height;
+
+    // Consecutive commands with the same texture and scissor are merged into one draw.
+    uint32_t batch_offset = 0;
+    uint32_t batch_count = 0;
+    std::array<uint32_t, 4> batch_scissor = {};
+    void* batch_texture = nullptr;
+    void* bound_texture = nullptr;
+    std::array<uint32_t, 4> bound_scissor = {UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX};
+
+    auto flush = [&]() {
+        if (batch_count == 0) {
+            return;
+        }
+        if (batch_scissor[2] > 0 && batch_scissor[3] > 0) {
+            if (batch_texture != bound_texture) {
+                WGPUBindGroup bind_group = get_texture_bind_group(nk, (WGPUTextureView)batch_texture);
+                assert(bind_group);
+                wgpuRenderPassEncoderSetBindGroup(render_pass, 0, bind_group, 0, nullptr);
+                bound_texture = batch_texture;
+            }
+            if (batch_scissor != bound_scissor) {
+                wgpuRenderPassEncoderSetScissorRect(
+                    render_pass, batch_scissor[0], batch_scissor[1], batch_scissor[2], batch_scissor[3]);
+                bound_scissor = batch_scissor;
+            }
+            wgpuRenderPassEncoderDrawIndexed(render_pass, batch_count, 1, batch_offset, 0, 0);
+            nk->stats.draw_calls++;
+        }
+        batch_offset += batch_count;
+        batch_count = 0;
+    };
+
+    const nk_draw_command* cmd;
+    nk_draw_foreach(cmd, &nk->ctx, &nk->cmds) {
+        if (!cmd->elem_count) {
+            continue;
+        }
+        nk->stats.commands++;
+
+        // Clamp the clip rect to the framebuffer, WebGPU rejects scissors outside of the attachment.
+        float x0 = NK_CLAMP(0.0f, cmd->clip_rect.x * scale_x, (float)nk->display_width);
+        float y0 = NK_CLAMP(0.0f, cmd->clip_rect.y * scale_y, (float)nk->display_height);
+        float x1 = NK_CLAMP(0.0f, (cmd->clip_rect.x + cmd->clip_rect.w) * scale_x, (float)nk->display_width);
+        float y1 = NK_CLAMP(0.0f, (cmd->clip_rect.y + cmd->clip_rect.h) * scale_y, (float)nk->display_height);
+
+        std::array<uint32_t, 4> scissor = {
+            (uint32_t)x0,
+            (uint32_t)y0,
+            (uint32_t)(x1 - x0),
+            (uint32_t)(y1 - y0),
+        };
+
+        if (batch_count == 0 || scissor != batch_scissor || cmd->texture.ptr != batch_texture) {
+            flush();
+            batch_scissor = scissor;
+            batch_texture = cmd->texture.ptr;
+        }
+        batch_count += cmd->elem_count;
+    }
+    flush();
+
+    nk_clear(&nk->ctx);
+}
+
+void nk_wgpu_shutdown(NkWgpu* nk) {
+    nk_font_atlas_clear(&nk->atlas);
+    nk_free(&nk->ctx);
+    nk_buffer_free(&nk->cmds);
+    nk_buffer_free(&nk->vertices);
+    nk_buffer_free(&nk->elements);
+
+    if (nk->vertex_buffer) {
+        wgpuBufferRelease(nk->vertex_buffer);
+    }
+    if (nk->index_buffer) {
+        wgpuBufferRelease(nk->index_buffer);
+    }
+    nk->bind_groups.clear();
+    wgpuTextureViewRelease(nk->font_view);
+    wgpuTextureRelease(nk->font_texture);
+    wgpuBufferRelease(nk->uniform_buffer);
+    wgpuSamplerRelease(nk->sampler);
+    wgpuRenderPipelineRelease(nk->pipeline);
+    wgpuPipelineLayoutRelease(nk->pipeline_layout);
+    wgpuBindGroupLayoutRelease(nk->bind_group_layout);
+
+    *nk = {};
+}
+
+void nk_wgpu_char_callback(NkWgpu* nk, unsigned int codepoint) {
+    if (nk->text_len < NK_WGPU_TEXT_MAX) {
+        nk->text[nk->text_len++] = codepoint;
+    }
+}
+
+void nk_wgpu_scroll_callback(NkWgpu* nk, double x_offset, double y_offset) {
+    nk->scroll.x += (float)x_offset;
+    nk->scroll.y += (float)y_offset;
+}
@@ -0,0 +1,99 @@
+#ifndef NUKLEAR_WGPU_H
+#define NUKLEAR_WGPU_H
+
+#include <cstdint>
+
+#include "bind_group_cache.h"
+#include "common.h"
+
+#define NK_INCLUDE_FIXED_TYPES
+#define NK_INCLUDE_STANDARD_IO
+#define NK_INCLUDE_STANDARD_VARARGS
+#define NK_INCLUDE_DEFAULT_ALLOCATOR
+#define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+#define NK_INCLUDE_FONT_BAKING
+#define NK_INCLUDE_DEFAULT_FONT
+// 32-bit indices keep every index upload a multiple of 4 bytes, as `wgpuQueueWriteBuffer` requires.
+#define NK_UINT_DRAW_INDEX
+#include <nuklear.h>
+
+struct GLFWwindow;
+
+#define NK_WGPU_TEXT_MAX 256
+
+struct NkWgpuVertex {
+    float position[2];
+    float uv[2];
+    nk_byte col[4];
+};
+
+/// Per-frame numbers of the last `nk_wgpu_render` call.
+struct NkWgpuStats {
+    uint32_t commands;
+    uint32_t draw_calls;
+    uint32_t vertices;
+    uint32_t indices;
+    uint64_t upload_bytes;
+};
+
+/// Nuklear backend drawing through WebGPU.
+///
+/// The whole UI of a frame is converted into one vertex and one index buffer, uploaded with a single
+/// `wgpuQueueWriteBuffer` each, and drawn with one `DrawIndexed` per run of commands sharing texture and scissor.
+struct NkWgpu {
+    GLFWwindow* window;
+    WGPUDevice device;
+    WGPUQueue queue;
+
+    nk_context ctx;
+    nk_font_atlas atlas;
+    nk_buffer cmds;
+    nk_draw_null_texture null_texture;
+
+    // CPU side of the streaming buffers, kept across frames to avoid reallocating.
+    nk_buffer vertices;
+    nk_buffer elements;
+
+    WGPUBindGroupLayout bind_group_layout;
+    WGPUPipelineLayout pipeline_layout;
+    WGPURenderPipeline pipeline;
+    WGPUSampler sampler;
+    WGPUTexture font_texture;
+    WGPUTextureView font_view;
+    WGPUBuffer uniform_buffer;
+    /// One bind group per texture drawn, keyed by the texture view in `nk_handle::ptr`.
+    BindGroupCache bind_groups;
+
+    WGPUBuffer vertex_buffer;
+    WGPUBuffer index_buffer;
+    size_t vertex_capacity;
+    size_t index_capacity;
+
+    int width, height;
+    int display_width, display_height;
+    int projection_width, projection_height;
+
+    unsigned int text[NK_WGPU_TEXT_MAX];
+    int text_len;
+    struct nk_vec2 scroll;
+
+    NkWgpuStats stats;
+};
+
+/// Creates the pipeline for `format` and bakes the default font. Input callbacks are not installed, forward
+/// them with `nk_wgpu_char_callback`/`nk_wgpu_scroll_callback`.
+nk_context* nk_wgpu_init(NkWgpu* nk, GLFWwindow* window, WGPUDevice device, WGPUQueue queue, WGPUTextureFormat format);
+
+/// Polls GLFW input into the Nuklear context. Call before building the UI.
+void nk_wgpu_new_frame(NkWgpu* nk);
+
+/// Uploads and records the UI built since `nk_wgpu_new_frame` into an open render pass.
+void nk_wgpu_render(NkWgpu* nk, WGPURenderPassEncoder render_pass, nk_anti_aliasing aa);
+
+void nk_wgpu_shutdown(NkWgpu* nk);
+
+void nk_wgpu_char_callback(NkWgpu* nk, unsigned int codepoint);
+
+void nk_wgpu_scroll_callback(NkWgpu* nk, double x_offset, double y_offset);
+
+#endif // NUKLEAR_WGPU_H
@@ -0,0 +1,200 @@
+#include "perf_overlay.h"
+
+#include <algorithm>
+
+static double elapsed_ms(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+static void handle_queue_work_done(WGPUQueueWorkDoneStatus status, void* userdata) {
+    auto overlay = (PerfOverlay*)userdata;
+    overlay->gpu_pending = false;
+    if (status == WGPUQueueWorkDoneStatus_Success) {
+        overlay->gpu_wait_ms = elapsed_ms(overlay->submit_time, std::chrono::steady_clock::now());
+    }
+}
+
+#ifndef EMSCRIPTEN
+static const WGPUHubReport* select_hub(const WGPUGlobalReport* report) {
+    switch (report->backendType) {
+        case WGPUBackendType_Vulkan:
+            return &report->vulkan;
+        case WGPUBackendType_Metal:
+            return &report->metal;
+        case WGPUBackendType_D3D12:
+            return &report->dx12;
+        case WGPUBackendType_OpenGL:
+        case WGPUBackendType_OpenGLES:
+            return &report->gl;
+        default:
+            return nullptr;
+    }
+}
+#endif
+
+static void refresh_counters(PerfOverlay* overlay, std::chrono::steady_clock::time_point now) {
+    double seconds = elapsed_ms(overlay->last_refresh, now) / 1000.0;
+    uint64_t bytes = uploaded_bytes();
+    if (seconds > 0) {
+        overlay->upload_mb_per_second = (double)(bytes - overlay->last_uploaded_bytes) / (1024.0 * 1024.0) / seconds;
+    }
+    overlay->last_uploaded_bytes = bytes;
+    overlay->last_refresh = now;
+
+#ifndef EMSCRIPTEN
+    WGPUGlobalReport report{};
+    wgpuGenerateReport(overlay->instance, &report);
+
+    if (const WGPUHubReport* hub = select_hub(&report)) {
+        overlay->objects = PerfObjectCounts{
+            .buffers = hub->buffers.numAllocated,
+            .textures = hub->textures.numAllocated,
+            .texture_views = hub->textureViews.numAllocated,
+            .samplers = hub->samplers.numAllocated,
+            .bind_groups = hub->bindGroups.numAllocated,
+            .render_pipelines = hub->renderPipelines.numAllocated,
+            .shader_modules = hub->shaderModules.numAllocated,
+            .command_buffers = hub->commandBuffers.numAllocated,
+        };
+    }
+#endif
+}
+
+void perf_overlay_init(PerfOverlay* overlay,
+                       GLFWwindow* window,
+                       WGPUInstance instance,
+                       WGPUDevice device,
+                       WGPUQueue queue,
+                       WGPUTextureFormat format) {
+    *overlay = {};
+    overlay->instance = instance;
+    overlay->device = device;
+    overlay->queue = queue;
+    overlay->refresh_interval = 0.5;
+    overlay->last_frame = std::chrono::steady_clock::now();
+    overlay->last_refresh = overlay->last_frame;
+    overlay->last_uploaded_bytes = uploaded_bytes();
+
+    nk_wgpu_init(&overlay->nk, window, device, queue, format);
+}
+
+void perf_overlay_begin_frame(PerfOverlay* overlay, bool after_idle) {
+    auto now = std::chrono::steady_clock::now();
+
+    if (!after_idle) {
+        overlay->history_head = (overlay->history_head + 1) % PERF_OVERLAY_HISTORY;
+        overlay->frame_ms[overlay->history_head] = (float)elapsed_ms(overlay->last_frame, now);
+        overlay->gpu_ms[overlay->history_head] = (float)overlay->gpu_wait_ms;
+    }
+    overlay->last_frame = now;
+
+    overlay->overlay_ms = overlay->overlay_frame_ms;
+    overlay->overlay_frame_ms = 0.0;
+    if (!overlay->visible) {
+        return;
+    }
+
+    if (elapsed_ms(overlay->last_refresh, now) >= overlay->refresh_interval * 1000.0) {
+        refresh_counters(overlay, now);
+        overlay->overlay_frame_ms += elapsed_ms(now, std::chrono::steady_clock::now());
+    }
+}
+
+void perf_overlay_render(PerfOverlay* overlay, WGPURenderPassEncoder render_pass) {
+    if (!overlay->visible) {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    NkWgpu* nk = &overlay->nk;
+    nk_context* ctx = &nk->ctx;
+    nk_wgpu_new_frame(nk);
+
+    if (nk_begin(ctx,
+                 "Performance",
+                 nk_rect(10, 10, 280, 440),
+                 NK_WINDOW_BORDER | NK_WINDOW_MOVABLE | NK_WINDOW_TITLE | NK_WINDOW_MINIMIZABLE)) {
+        // Oldest sample first.
+        int offset = (overlay->history_head + 1) % PERF_OVERLAY_HISTORY;
+        float max_frame_ms = *std::max_element(overlay->frame_ms, overlay->frame_ms + PERF_OVERLAY_HISTORY);
+
+        nk_layout_row_dynamic(ctx, 16, 1);
+        nk_labelf(ctx,
+                  NK_TEXT_LEFT,
+                  "Frame %.2f ms (max %.2f ms)",
+                  overlay->frame_ms[overlay->history_head],
+                  max_frame_ms);
+        nk_layout_row_dynamic(ctx, 50, 1);
+        nk_plot(ctx, NK_CHART_LINES, overlay->frame_ms, PERF_OVERLAY_HISTORY, offset);
+
+        nk_layout_row_dynamic(ctx, 16, 1);
+        nk_labelf(ctx, NK_TEXT_LEFT, "GPU wait after submit %.2f ms", overlay->gpu_wait_ms);
+        nk_layout_row_dynamic(ctx, 50, 1);
+        nk_plot(ctx, NK_CHART_LINES, overlay->gpu_ms, PERF_OVERLAY_HISTORY, offset);
+
+        nk_layout_row_dynamic(ctx, 16, 2);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Acquire wait %.3f ms", overlay->cpu_acquire_ms);
+        nk_labelf(ctx, NK_TEXT_LEFT, "CPU scene %.3f ms", overlay->cpu_scene_ms);
+        nk_labelf(ctx, NK_TEXT_LEFT, "CPU submit %.3f ms", overlay->cpu_submit_ms);
+        nk_labelf(ctx, NK_TEXT_LEFT, "CPU present %.3f ms", overlay->cpu_present_ms);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Scene draws %u", overlay->scene_draws);
+        nk_labelf(ctx, NK_TEXT_LEFT, "States saved %u", overlay->scene_state_changes_saved);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Overlay %.3f ms", overlay->overlay_ms);
+        nk_labelf(ctx, NK_TEXT_LEFT, "UI draws %u", nk->stats.draw_calls);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Upload %.2f MB/s", overlay->upload_mb_per_second);
+        nk_labelf(ctx, NK_TEXT_LEFT, "UI verts %u", nk->stats.vertices);
+
+        const PerfObjectCounts& objects = overlay->objects;
+        nk_labelf(ctx, NK_TEXT_LEFT, "Buffers %zu", objects.buffers);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Textures %zu", objects.textures);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Views %zu", objects.texture_views);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Samplers %zu", objects.samplers);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Bind groups %zu", objects.bind_groups);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Pipelines %zu", objects.render_pipelines);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Shaders %zu", objects.shader_modules);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Cmd buffers %zu", objects.command_buffers);
+        nk_labelf(ctx, NK_TEXT_LEFT, "UI BG hits %.1f%%", nk->bind_groups.stats().hit_rate() * 100.0);
+    }
+    nk_end(ctx);
+
+    nk_wgpu_render(nk, render_pass, NK_ANTI_ALIASING_ON);
+
+    overlay->overlay_frame_ms += elapsed_ms(start, std::chrono::steady_clock::now());
+}
+
+void perf_overlay_on_submit(PerfOverlay* overlay) {
+    // Only one measurement in flight, the callback writes into the overlay.
+    if (!overlay->visible || overlay->gpu_pending) {
+        return;
+    }
+
+    overlay->gpu_pending = true;
+    overlay->submit_time = std::chrono::steady_clock::now();
+    wgpuQueueOnSubmittedWorkDone(overlay->queue, handle_queue_work_done, overlay);
+
+#ifndef EMSCRIPTEN
+    // The work-done callback only fires from a poll. Polling on the next frame would measure the frame interval,
+    // or the whole idle sleep with --on-demand, so wait for this submission here instead.
+    wgpuDevicePoll(overlay->device, true, nullptr);
+#endif
+}
+
+bool perf_overlay_needs_refresh(const PerfOverlay* overlay) {
+    if (!overlay->visible) {
+        return false;
+    }
+
+    return elapsed_ms(overlay->last_refresh, std::chrono::steady_clock::now()) >= overlay->refresh_interval * 1000.0;
+}
+
+void perf_overlay_shutdown(PerfOverlay* overlay) {
+    // Flush a pending work-done callback before the overlay goes away.
+#ifndef EMSCRIPTEN
+    if (overlay->gpu_pending) {
+        wgpuDevicePoll(overlay->device, true, nullptr);
+    }
+#endif
+
+    nk_wgpu_shutdown(&overlay->nk);
+}
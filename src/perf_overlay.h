@@ -0,0 +1,90 @@
+#ifndef PERF_OVERLAY_H
+#define PERF_OVERLAY_H
+
+#include <chrono>
+#include <cstdint>
+
+#include "nuklear_wgpu.h"
+
+#define PERF_OVERLAY_HISTORY 120
+
+/// Live objects of the active backend, as reported by `wgpuGenerateReport`.
+struct PerfObjectCounts {
+    size_t buffers;
+    size_t textures;
+    size_t texture_views;
+    size_t samplers;
+    size_t bind_groups;
+    size_t render_pipelines;
+    size_t shader_modules;
+    size_t command_buffers;
+};
+
+/// In-app window with frame time graphs, pass timings, object counts and upload bandwidth.
+struct PerfOverlay {
+    NkWgpu nk;
+    WGPUInstance instance;
+    WGPUDevice device;
+    WGPUQueue queue;
+    bool visible;
+
+    // Filled by the caller every frame.
+    /// Waiting for `wgpuSurfaceGetCurrentTexture`, mostly the swap chain throttling to the display.
+    double cpu_acquire_ms;
+    /// Recording the scene, from the acquired texture to the end of its draws.
+    double cpu_scene_ms;
+    double cpu_submit_ms;
+    double cpu_present_ms;
+    uint32_t scene_draws;
+    uint32_t scene_state_changes_saved;
+
+    // Ring buffers for the graphs.
+    float frame_ms[PERF_OVERLAY_HISTORY];
+    float gpu_ms[PERF_OVERLAY_HISTORY];
+    int history_head;
+
+    /// Time the CPU waited after `wgpuQueueSubmit` for the queue to finish the frame. This is GPU execution plus
+    /// queueing, and only measured while the overlay is visible since the wait stalls the frame.
+    double gpu_wait_ms;
+    bool gpu_pending;
+    std::chrono::steady_clock::time_point submit_time;
+
+    /// CPU cost of the overlay itself last frame: refreshing the counters, building the UI and recording it. The
+    /// GPU wait above is not included.
+    double overlay_ms;
+    /// The same, summed up over the frame being built.
+    double overlay_frame_ms;
+
+    std::chrono::steady_clock::time_point last_frame;
+
+    // Slow-changing numbers are only refreshed every `refresh_interval` seconds.
+    double refresh_interval;
+    std::chrono::steady_clock::time_point last_refresh;
+    uint64_t last_uploaded_bytes;
+    double upload_mb_per_second;
+    PerfObjectCounts objects;
+};
+
+void perf_overlay_init(PerfOverlay* overlay,
+                       GLFWwindow* window,
+                       WGPUInstance instance,
+                       WGPUDevice device,
+                       WGPUQueue queue,
+                       WGPUTextureFormat format);
+
+/// Call once per rendered frame, before anything is recorded. `after_idle` is set when the loop slept since the
+/// previous frame; the gap is then left out of the graphs. Does nothing else when hidden.
+void perf_overlay_begin_frame(PerfOverlay* overlay, bool after_idle = false);
+
+/// Builds the UI and records it into `render_pass`. Does nothing when hidden.
+void perf_overlay_render(PerfOverlay* overlay, WGPURenderPassEncoder render_pass);
+
+/// Call right after `wgpuQueueSubmit`. When visible, blocks until the submitted work is done to measure it.
+void perf_overlay_on_submit(PerfOverlay* overlay);
+
+/// True when the overlay has new numbers to show, so idle loops can schedule a redraw.
+bool perf_overlay_needs_refresh(const PerfOverlay* overlay);
+
+void perf_overlay_shutdown(PerfOverlay* overlay);
+
+#endif // PERF_OVERLAY_H
@@ -0,0 +1,52 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Fixed set of worker threads for data-parallel loops. The calling thread takes part in every loop.
+class ThreadPool {
+public:
+    /// `thread_count` includes the calling thread, 0 picks one per hardware thread.
+    explicit ThreadPool(uint32_t thread_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Total number of threads running a loop, including the caller.
+    uint32_t size() const {
+        return (uint32_t)workers.size() + 1;
+    }
+
+    /// Calls `body(begin, end)` for consecutive ranges of at most `grain` items covering [0, count), spread over
+    /// all threads, and returns once every range is done. Ranges start at multiples of `grain`.
+    void parallel_for(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& body);
+
+private:
+    void worker_loop();
+    void run_ranges();
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t generation = 0;
+    uint32_t active = 0;
+    bool stopping = false;
+
+    // The loop currently being run.
+    const std::function<void(size_t, size_t)>* body = nullptr;
+    size_t count = 0;
+    size_t grain = 1;
+    std::atomic<size_t> next{0};
+};
+
+#endif // THREAD_POOL_H
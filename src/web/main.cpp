@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "../common.h"
+#include "../draw_queue.h"
 #include "emscripten.h"
 #include "emscripten/html5.h"
 #include "emscripten/html5_webgpu.h"
@@ -37,6 +38,7 @@ struct AppState {
         WGPUQueue queue;
         WGPUSwapChain swapchain;
         WGPURenderPipeline pipeline;
+        DrawQueue draw_queue;
     } wgpu;
 
     // resources
@@ -247,8 +249,15 @@ void draw() {
     WGPURenderPassEncoder render_pass = wgpuCommandEncoderBeginRenderPass(cmd_encoder, &render_pass_descriptor);
 
     {
-        wgpuRenderPassEncoderSetPipeline(render_pass, state.wgpu.pipeline);
-        wgpuRenderPassEncoderDraw(render_pass, 3, 1, 0, 0);
+        DrawQueue& draw_queue = state.wgpu.draw_queue;
+        draw_queue.reset();
+        draw_queue.submit(DrawItem{
+            .pipeline = state.wgpu.pipeline,
+            .count = 3,
+            .instance_count = 1,
+        });
+        draw_queue.sort();
+        draw_queue.encode(render_pass, 0);
     }
 
     // End render pass.